@@ -0,0 +1,89 @@
+#ifndef ACTION_H
+#define ACTION_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "settings_data.h"
+
+/**
+ * @brief The kinds of action a player can take on their turn
+ */
+enum class ActionType : std::uint8_t {
+    MOVE,       // Move a piece one step, sliding over blank cells
+    HOP,        // Use a hop powerup to move a piece two steps
+    PORTAL,     // Use a portal powerup to turn two regular cells into a portal pair
+    DESTROYER,  // Use a destroyer powerup to remove a barrier
+    BISHOP,     // Use a bishop powerup to upgrade a piece
+
+    COUNT  // Variable at the end to get the number of action types
+};
+
+/**
+ * @brief A single action, with cells stored as row-major indices into the board
+ * @note origin is the moved piece, the first portal cell, the destroyed barrier or the upgraded piece.
+ * target is the destination of a move or hop and the second portal cell, and is unused otherwise.
+ * Members have no default initialisers so an ActionList can be created without writing every slot
+ */
+struct Action {
+    ActionType type;
+    std::uint8_t origin;
+    std::uint8_t target;
+
+    bool operator==(const Action &other) const = default;
+};
+
+// Upper bound on the actions available in any position: a move and a hop in each of four
+// directions and a bishop upgrade for every piece, a destroyer for every barrier and a
+// portal for every pair of regular cells
+inline constexpr std::size_t MAX_ACTIONS = 9 * MAX_CELLS + MAX_CELLS + MAX_CELLS * (MAX_CELLS - 1) / 2;
+
+/**
+ * @brief A fixed capacity list of actions, so generating actions never allocates
+ */
+struct ActionList {
+    std::array<Action, MAX_ACTIONS> actions;
+    std::size_t size = 0;
+
+    /**
+     * @brief Appends an action to the list
+     */
+    inline void push(const ActionType type, const int origin, const int target = 0) {
+        actions[size++] = {type, static_cast<std::uint8_t>(origin), static_cast<std::uint8_t>(target)};
+    }
+
+    inline void clear() {
+        size = 0;
+    }
+
+    inline bool empty() const {
+        return size == 0;
+    }
+
+    inline const Action &operator[](const std::size_t index) const {
+        return actions[index];
+    }
+
+    inline Action &operator[](const std::size_t index) {
+        return actions[index];
+    }
+
+    inline const Action *begin() const {
+        return actions.data();
+    }
+
+    inline const Action *end() const {
+        return actions.data() + size;
+    }
+
+    inline Action *begin() {
+        return actions.data();
+    }
+
+    inline Action *end() {
+        return actions.data() + size;
+    }
+};
+
+#endif  // ACTION_H
@@ -0,0 +1,99 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <cstddef>
+#include <memory>
+#include <new>  // placement new
+#include <type_traits>
+#include <vector>
+
+/**
+ * @brief A bump allocator that hands out memory from large blocks and releases it all at once
+ * @note Allocating is a pointer increment, and reset rewinds to the start of the first block
+ * while keeping every block, so an arena reused between searches stops allocating once it has
+ * grown to the size of the largest search. Objects are never destroyed, so only trivially
+ * destructible types can be allocated. An arena must only be used by one thread at a time
+ */
+class Arena {
+   public:
+    /**
+     * @brief Construct a new Arena object
+     * @param capacity The most bytes the arena hands out before allocations fail
+     * @param blockSize The size of each block requested from the system
+     */
+    explicit Arena(const std::size_t capacity, const std::size_t blockSize = std::size_t{1} << 20)
+        : capacity(capacity), blockSize(blockSize) {}
+
+    /**
+     * @brief Allocates and default constructs an array of objects
+     * @tparam T The type of the objects
+     * @param count The number of objects
+     * @return A pointer to the first object, or nullptr if the arena's capacity would be exceeded
+     */
+    template <typename T>
+    T *allocate(const std::size_t count) {
+        static_assert(std::is_trivially_destructible_v<T>, "Arena objects are never destroyed");
+        static_assert(alignof(T) <= alignof(std::max_align_t), "Blocks are only aligned for fundamental types");
+        const std::size_t bytes = count * sizeof(T);
+        if (used + bytes > capacity) {
+            return nullptr;
+        }
+        std::size_t start = (offset + alignof(T) - 1) / alignof(T) * alignof(T);
+        while (blockIndex >= blocks.size() || start + bytes > blocks[blockIndex].size) {
+            // Move on to the next block, or add one large enough for this allocation
+            if (blockIndex < blocks.size()) {
+                blockIndex++;
+            }
+            if (blockIndex == blocks.size()) {
+                const std::size_t size = bytes > blockSize ? bytes : blockSize;
+                blocks.push_back({std::make_unique<std::byte[]>(size), size});
+            }
+            start = 0;
+        }
+        T *objects = reinterpret_cast<T *>(blocks[blockIndex].memory.get() + start);
+        for (std::size_t i = 0; i < count; i++) {
+            new (&objects[i]) T;
+        }
+        used += bytes;
+        offset = start + bytes;
+        return objects;
+    }
+
+    /**
+     * @brief Releases every allocation at once, keeping the blocks for reuse
+     */
+    void reset() {
+        blockIndex = 0;
+        offset = 0;
+        used = 0;
+    }
+
+    /**
+     * @brief Gets the most bytes the arena hands out
+     */
+    std::size_t getCapacity() const {
+        return capacity;
+    }
+
+    /**
+     * @brief Gets the number of bytes handed out since the last reset
+     */
+    std::size_t bytesUsed() const {
+        return used;
+    }
+
+   private:
+    struct Block {
+        std::unique_ptr<std::byte[]> memory;
+        std::size_t size;
+    };
+
+    std::vector<Block> blocks;
+    std::size_t blockIndex = 0;  // Block currently being allocated from
+    std::size_t offset = 0;      // Offset of the first free byte in the current block
+    std::size_t used = 0;        // Bytes handed out since the last reset
+    std::size_t capacity;
+    std::size_t blockSize;
+};
+
+#endif  // ARENA_H
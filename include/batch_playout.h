@@ -0,0 +1,34 @@
+#ifndef BATCH_PLAYOUT_H
+#define BATCH_PLAYOUT_H
+
+#include <array>
+#include <cstdint>
+
+struct Game;
+
+/**
+ * @brief Limits on a batch of random playouts
+ */
+struct PlayoutLimits {
+    int games;           // Number of playouts to run
+    int maxPlies;        // Plies after which an unfinished playout is stopped
+    std::uint32_t seed;  // Seed each playout's generator is derived from
+};
+
+/**
+ * @brief The outcome of a batch of random playouts
+ */
+struct BatchPlayoutResult {
+    std::uint64_t games = 0;             // Number of playouts run
+    std::uint64_t plies = 0;             // Plies played by every playout
+    std::array<std::uint64_t, 2> wins{};  // Playouts won by player 1 and by player 2
+    std::uint64_t unfinished = 0;        // Playouts stopped at the ply limit
+    double seconds = 0.0;                // Time spent playing
+
+    double pliesPerSecond() const;
+};
+
+int playoutLanes();
+BatchPlayoutResult runBatchPlayouts(const Game &game, const PlayoutLimits &limits);
+
+#endif  // BATCH_PLAYOUT_H
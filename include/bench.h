@@ -0,0 +1,11 @@
+#ifndef BENCH_H
+#define BENCH_H
+
+#include <ostream>
+
+#include "enums.h"
+
+void benchParallelSearch(const int threads, const int depth, std::ostream &out);
+void benchPlayouts(const Map map, const int games, const int maxPlies, std::ostream &out);
+
+#endif  // BENCH_H
@@ -0,0 +1,131 @@
+#ifndef BITBOARD_H
+#define BITBOARD_H
+
+#include <array>
+#include <bit>  // std::popcount, std::countr_zero
+#include <cstdint>
+
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
+#include "settings_data.h"
+
+/**
+ * @brief A 256-bit set with one bit per board cell, indexed in row-major order
+ * @note Boards are at most MAX_CELLS cells, so any board fits in a single plane.
+ * Bitwise operations use AVX2 when it is available and fall back to four 64-bit words otherwise
+ */
+struct alignas(32) Bitboard {
+    std::array<std::uint64_t, 4> words{};
+
+    static_assert(MAX_CELLS <= 256, "Board cells must fit in a 256-bit plane");
+
+    /**
+     * @brief Sets the bit of a cell
+     * @param index The row-major index of the cell
+     */
+    inline void set(const int index) {
+        words[index >> 6] |= std::uint64_t{1} << (index & 63);
+    }
+
+    /**
+     * @brief Clears the bit of a cell
+     * @param index The row-major index of the cell
+     */
+    inline void reset(const int index) {
+        words[index >> 6] &= ~(std::uint64_t{1} << (index & 63));
+    }
+
+    /**
+     * @brief Checks whether the bit of a cell is set
+     * @param index The row-major index of the cell
+     * @return True if the bit is set, false otherwise
+     */
+    inline bool test(const int index) const {
+        return (words[index >> 6] >> (index & 63)) & 1;
+    }
+
+    /**
+     * @brief Counts the number of set bits
+     */
+    inline int count() const {
+        return std::popcount(words[0]) + std::popcount(words[1]) + std::popcount(words[2]) + std::popcount(words[3]);
+    }
+
+    /**
+     * @brief Checks whether any bit is set
+     */
+    inline bool any() const {
+#ifdef __AVX2__
+        const __m256i vector = load();
+        return !_mm256_testz_si256(vector, vector);
+#else
+        return (words[0] | words[1] | words[2] | words[3]) != 0;
+#endif
+    }
+
+    /**
+     * @brief Checks whether no bit is set
+     */
+    inline bool none() const {
+        return !any();
+    }
+
+    /**
+     * @brief Calls a function with the index of every set bit, in ascending order
+     * @tparam Function A callable taking an int
+     * @param function The function to call
+     */
+    template <typename Function>
+    void forEach(Function &&function) const {
+        for (int word = 0; word < 4; word++) {
+            std::uint64_t bits = words[word];
+            while (bits != 0) {
+                function(word * 64 + std::countr_zero(bits));
+                bits &= bits - 1;  // clear the lowest set bit
+            }
+        }
+    }
+
+    inline Bitboard operator|(const Bitboard &other) const {
+#ifdef __AVX2__
+        return fromVector(_mm256_or_si256(load(), other.load()));
+#else
+        return {{words[0] | other.words[0], words[1] | other.words[1], words[2] | other.words[2], words[3] | other.words[3]}};
+#endif
+    }
+
+    inline Bitboard operator&(const Bitboard &other) const {
+#ifdef __AVX2__
+        return fromVector(_mm256_and_si256(load(), other.load()));
+#else
+        return {{words[0] & other.words[0], words[1] & other.words[1], words[2] & other.words[2], words[3] & other.words[3]}};
+#endif
+    }
+
+    inline Bitboard &operator|=(const Bitboard &other) {
+        return *this = *this | other;
+    }
+
+    inline Bitboard &operator&=(const Bitboard &other) {
+        return *this = *this & other;
+    }
+
+    bool operator==(const Bitboard &other) const = default;
+
+#ifdef __AVX2__
+   private:
+    inline __m256i load() const {
+        return _mm256_load_si256(reinterpret_cast<const __m256i *>(words.data()));
+    }
+
+    static inline Bitboard fromVector(const __m256i vector) {
+        Bitboard result;
+        _mm256_store_si256(reinterpret_cast<__m256i *>(result.words.data()), vector);
+        return result;
+    }
+#endif
+};
+
+#endif  // BITBOARD_H
@@ -1,31 +1,88 @@
 #ifndef BOARD_H
 #define BOARD_H
 
+#include <array>
+#include <cstdint>
 #include <map>
+#include <memory>
+#include <optional>
 #include <set>
+#include <string>
+#include <utility>  // std::forward
 #include <vector>
 
+#include "bitboard.h"
+#include "board_geometry.h"
 #include "cell.h"
+#include "evaluation.h"
+#include "field.h"
 #include "portal.h"
+#include "random.h"
 #include "settings_data.h"
+#include "slide_table.h"
+#include "symmetry.h"
 
 struct Board {
-    std::vector<std::vector<Cell>> field;
+    Field field;
     const int length;
     const int width;
+    std::array<Bitboard, NUM_CELL_KINDS> planes{};  // One plane per cell kind, kept in sync with the field
+    SymmetryTable symmetries{};                     // Where each symmetry moves each cell
+    std::array<std::uint64_t, NUM_SYMMETRIES> hashes{};  // Zobrist hash of the field under each symmetry, kept in sync with the field
+    SlideTable slides{};                            // Stopping squares of slides over blank cells
+    std::shared_ptr<const EvalTables> evalTables;   // Evaluation terms of each cell kind, shared by copies of the board
+    Accumulator accumulator{};                      // Evaluation features of the field, kept in sync with the field
 
     explicit Board(SettingsData const &settingsData);
 
-    std::vector<std::vector<Cell>> generateRandomMap(const SettingsData &settingsData) const;
+    Field generateRandomMap(const SettingsData &settingsData, Random &random) const;
     std::set<std::pair<int, int>> scanCells(const Cell &targetCell) const;
     std::set<std::pair<int, int>> scanCells(const std::set<Cell> &targetCells) const;
+    std::set<std::pair<int, int>> scanPlane(const Bitboard &plane) const;
 
-    void placePowerup();
+    /**
+     * @brief Calls a visitor with the geometry of the board, specialised at compile time for common sizes
+     * @tparam Visitor A callable accepting any geometry
+     * @param visitor The visitor to call
+     * @return The result of the visitor
+     */
+    template <typename Visitor>
+    decltype(auto) visitGeometry(Visitor &&visitor) const {
+        return ::visitGeometry(length, width, std::forward<Visitor>(visitor));
+    }
+
+    void placePowerup(Random &random = Random::getInstance());
     void replaceCell(const std::pair<int, int> &coord, const Cell &newCell);
     bool isWithinBounds(const std::pair<int, int> &coord) const;
-    void show() const;
-    Cell getCell(const std::pair<int, int> &coord) const;
+    std::string render() const;
+    const Cell &getCell(const std::pair<int, int> &coord) const;
+    std::optional<std::pair<int, int>> slide(const std::pair<int, int> &origin, const std::pair<int, int> &vector) const;
     void setCell(const std::pair<int, int> &coord, const Cell &newCell);
+    void toggleHashes(const int index, const Cell &cell);
+    void updateAccumulator(const std::pair<int, int> &coord, const Cell &oldCell, const Cell &newCell);
+
+    /**
+     * @brief Gets the plane of all cells of a given kind
+     * @param cell The cell to get the plane of
+     * @return The plane of the cell
+     */
+    inline const Bitboard &plane(const Cell &cell) const {
+        return planes[cell.index()];
+    }
+
+    /**
+     * @brief Converts a coordinate to its row-major index
+     */
+    inline int toIndex(const std::pair<int, int> &coord) const {
+        return coord.first * width + coord.second;
+    }
+
+    /**
+     * @brief Converts a row-major index to its coordinate
+     */
+    inline std::pair<int, int> toCoord(const int index) const {
+        return {index / width, index % width};
+    }
 };
 
 #endif  // BOARD_H
\ No newline at end of file
@@ -0,0 +1,94 @@
+#ifndef BOARD_GEOMETRY_H
+#define BOARD_GEOMETRY_H
+
+#include <set>
+#include <utility>  // std::pair
+
+#include "bitboard.h"
+
+/**
+ * @brief Board dimensions that are only known at runtime
+ * @note Used as the fallback for board sizes without a FixedGeometry specialisation
+ */
+struct RuntimeGeometry {
+    int length;  // Number of rows
+    int width;   // Number of columns
+};
+
+/**
+ * @brief Board dimensions known at compile time, letting the compiler fold bounds checks
+ * and index arithmetic into constants and unroll loops over the board
+ * @tparam Length The number of rows
+ * @tparam Width The number of columns
+ */
+template <int Length, int Width>
+struct FixedGeometry {
+    static constexpr int length = Length;
+    static constexpr int width = Width;
+
+    static_assert(Length * Width <= MAX_CELLS, "Fixed geometry does not fit in a bitboard");
+};
+
+/**
+ * @brief Calls a visitor with the geometry matching some board dimensions
+ * @tparam Visitor A callable accepting any geometry
+ * @param length The number of rows of the board
+ * @param width The number of columns of the board
+ * @param visitor The visitor to call
+ * @return The result of the visitor
+ * @note The 5x5 default and the 6x6 Breakout map are specialised, every other size uses RuntimeGeometry
+ */
+template <typename Visitor>
+decltype(auto) visitGeometry(const int length, const int width, Visitor &&visitor) {
+    if (length == 5 && width == 5) {
+        return visitor(FixedGeometry<5, 5>{});
+    } else if (length == 6 && width == 6) {
+        return visitor(FixedGeometry<6, 6>{});
+    }
+    return visitor(RuntimeGeometry{length, width});
+}
+
+/**
+ * @brief Checks if a coordinate is within the bounds of a geometry
+ * @param geometry The geometry of the board
+ * @param coord The coordinate to check
+ * @return True if the coordinate is within bounds, false otherwise
+ */
+template <typename Geometry>
+constexpr bool isWithinBounds(const Geometry &geometry, const std::pair<int, int> &coord) {
+    return coord.first >= 0 && coord.first < geometry.length && coord.second >= 0 && coord.second < geometry.width;
+}
+
+/**
+ * @brief Converts a coordinate to its row-major index
+ */
+template <typename Geometry>
+constexpr int toIndex(const Geometry &geometry, const std::pair<int, int> &coord) {
+    return coord.first * geometry.width + coord.second;
+}
+
+/**
+ * @brief Converts a row-major index to its coordinate
+ */
+template <typename Geometry>
+constexpr std::pair<int, int> toCoord(const Geometry &geometry, const int index) {
+    return {index / geometry.width, index % geometry.width};
+}
+
+/**
+ * @brief Gets the coordinates of every cell in a plane
+ * @param geometry The geometry of the board
+ * @param plane The plane to convert
+ * @return The coordinates of the set bits of the plane
+ */
+template <typename Geometry>
+std::set<std::pair<int, int>> scanPlane(const Geometry &geometry, const Bitboard &plane) {
+    std::set<std::pair<int, int>> coords;
+    // Bits are visited in row-major order, so each coordinate can be appended at the end of the set
+    plane.forEach([&geometry, &coords](const int index) {
+        coords.emplace_hint(coords.end(), toCoord(geometry, index));
+    });
+    return coords;
+}
+
+#endif  // BOARD_GEOMETRY_H
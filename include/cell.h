@@ -1,53 +1,146 @@
 #ifndef CELL_H
 #define CELL_H
 
-#include <string>
+#include <array>
+#include <cstddef>  // std::size_t
+#include <cstdint>  // std::uint8_t
+#include <span>
+#include <string_view>
+#include <type_traits>
 
 // define colours
-static const std::string RED = "\033[31m";
-static const std::string BLUE = "\033[34m";
-static const std::string GREEN = "\033[32m";
-static const std::string PINK = "\033[95m";
-static const std::string PURPLE = "\033[35m";
-static const std::string RESET = "\033[0m";  // reset character to disable colour
+inline constexpr std::string_view RED = "\033[31m";
+inline constexpr std::string_view BLUE = "\033[34m";
+inline constexpr std::string_view GREEN = "\033[32m";
+inline constexpr std::string_view PINK = "\033[95m";
+inline constexpr std::string_view PURPLE = "\033[35m";
+inline constexpr std::string_view RESET = "\033[0m";  // reset character to disable colour
 
+/**
+ * @brief The kinds of cell that can appear on the board
+ * @note The underlying value indexes the character and colour palettes below
+ */
+enum class CellKind : std::uint8_t {
+    BLANK,
+    REGULAR,
+    PLAYER_1,
+    PLAYER_2,
+    POWERUP_SOURCE,
+    BARRIER,
+    CRUMBLY,
+    PORTAL,
+    HOP,
+    PORTAL_POWER,
+    DESTROYER,
+    BISHOP_POWER,
+    BISHOP_1,
+    BISHOP_2,
+
+    COUNT  // Variable at the end to get the number of cell kinds
+};
+
+inline constexpr std::size_t NUM_CELL_KINDS = static_cast<std::size_t>(CellKind::COUNT);
+
+// Character of each cell kind, indexed by CellKind
+inline constexpr std::array<char, NUM_CELL_KINDS> CELL_CHARACTERS = {
+    ' ', '/', 'O', 'O', 'S', '#', '~', '@', 'H', 'P', 'D', 'B', '!', '!'};
+
+// Colour of each cell kind, indexed by CellKind
+inline constexpr std::array<std::string_view, NUM_CELL_KINDS> CELL_COLOURS = {
+    RESET, RESET, BLUE, RED, PINK, RESET, RESET, PURPLE, PINK, PINK, PINK, PINK, BLUE, RED};
+
+// Maximum number of characters written by Cell::repr
+inline constexpr std::size_t MAX_REPR_LENGTH = 16;
+
+/**
+ * @brief A pre-built escape sequence (colour, character, reset) for displaying a cell
+ */
+struct CellRepr {
+    std::array<char, MAX_REPR_LENGTH> characters{};
+    std::size_t size = 0;
+};
+
+/**
+ * @brief Builds the escape sequence of every cell kind at compile time
+ * @return The escape sequences, indexed by CellKind
+ */
+consteval std::array<CellRepr, NUM_CELL_KINDS> buildCellReprs() {
+    std::array<CellRepr, NUM_CELL_KINDS> reprs{};
+    for (std::size_t kind = 0; kind < NUM_CELL_KINDS; kind++) {
+        auto &repr = reprs[kind];
+        for (const char character : CELL_COLOURS[kind]) {
+            repr.characters[repr.size++] = character;
+        }
+        repr.characters[repr.size++] = CELL_CHARACTERS[kind];
+        for (const char character : RESET) {
+            repr.characters[repr.size++] = character;
+        }
+    }
+    return reprs;
+}
+
+inline constexpr std::array<CellRepr, NUM_CELL_KINDS> CELL_REPRS = buildCellReprs();
+
+/**
+ * @brief A single board cell, stored as a one byte kind
+ * @note Trivially copyable, so fields of cells can be copied with a memcpy
+ */
 struct Cell {
-    char character;
-    std::string colour;
+    CellKind kind = CellKind::BLANK;
 
     Cell() = default;
-    explicit Cell(const char character, const std::string_view &colour);
+    constexpr explicit Cell(const CellKind kind) : kind(kind) {}
+
+    /**
+     * @brief Gets the character the cell is displayed as
+     */
+    constexpr char character() const {
+        return CELL_CHARACTERS[index()];
+    }
+
+    /**
+     * @brief Gets the colour escape sequence the cell is displayed in
+     */
+    constexpr std::string_view colour() const {
+        return CELL_COLOURS[index()];
+    }
 
-    std::string repr() const;
+    /**
+     * @brief Gets the index of the cell's kind in the palettes
+     */
+    constexpr std::size_t index() const {
+        return static_cast<std::size_t>(kind);
+    }
+
+    std::size_t repr(std::span<char> buffer) const;
     void update(const Cell &cell);
-    void update(const char &newCharacter, const std::string_view &newColour);
+    void update(const CellKind &newKind);
 
     bool operator==(const Cell &cell) const = default;
 
     // Define the < operator to allow Cells to be in sets
-    bool operator<(const Cell &other) const {
-        if (character != other.character) {
-            return character < other.character;
-        }
-        return colour < other.colour;
+    constexpr bool operator<(const Cell &other) const {
+        return kind < other.kind;
     }
 };
 
+static_assert(sizeof(Cell) == 1 && std::is_trivially_copyable_v<Cell>);
+
 Cell charToCell(const char &character);
 
-static const Cell BLANK_CELL = Cell(' ', RESET);
-static const Cell REGULAR_CELL = Cell('/', RESET);
-static const Cell PLAYER_1_CELL = Cell('O', BLUE);
-static const Cell PLAYER_2_CELL = Cell('O', RED);
-static const Cell POWERUP_SOURCE_CELL = Cell('S', PINK);
-static const Cell BARRIER_CELL = Cell('#', RESET);
-static const Cell CRUMBLY_CELL = Cell('~', RESET);
-static const Cell PORTAL_CELL = Cell('@', PURPLE);
-static const Cell HOP_CELL = Cell('H', PINK);
-static const Cell PORTAL_POWER_CELL = Cell('P', PINK);
-static const Cell DESTROYER_CELL = Cell('D', PINK);
-static const Cell BISHOP_POWER_CELL = Cell('B', PINK);
-static const Cell BISHOP_1_CELL = Cell('!', BLUE);
-static const Cell BISHOP_2_CELL = Cell('!', RED);
-
-#endif  // CELL_H
\ No newline at end of file
+inline constexpr Cell BLANK_CELL = Cell(CellKind::BLANK);
+inline constexpr Cell REGULAR_CELL = Cell(CellKind::REGULAR);
+inline constexpr Cell PLAYER_1_CELL = Cell(CellKind::PLAYER_1);
+inline constexpr Cell PLAYER_2_CELL = Cell(CellKind::PLAYER_2);
+inline constexpr Cell POWERUP_SOURCE_CELL = Cell(CellKind::POWERUP_SOURCE);
+inline constexpr Cell BARRIER_CELL = Cell(CellKind::BARRIER);
+inline constexpr Cell CRUMBLY_CELL = Cell(CellKind::CRUMBLY);
+inline constexpr Cell PORTAL_CELL = Cell(CellKind::PORTAL);
+inline constexpr Cell HOP_CELL = Cell(CellKind::HOP);
+inline constexpr Cell PORTAL_POWER_CELL = Cell(CellKind::PORTAL_POWER);
+inline constexpr Cell DESTROYER_CELL = Cell(CellKind::DESTROYER);
+inline constexpr Cell BISHOP_POWER_CELL = Cell(CellKind::BISHOP_POWER);
+inline constexpr Cell BISHOP_1_CELL = Cell(CellKind::BISHOP_1);
+inline constexpr Cell BISHOP_2_CELL = Cell(CellKind::BISHOP_2);
+
+#endif  // CELL_H
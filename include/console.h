@@ -0,0 +1,47 @@
+#ifndef CONSOLE_H
+#define CONSOLE_H
+
+#include <functional>
+#include <map>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "action.h"
+#include "board.h"
+#include "cell.h"
+#include "enums.h"
+#include "game.h"
+#include "piece.h"
+#include "player.h"
+#include "settings_data.h"
+#include "transposition_table.h"
+
+// The console front end: everything that reads from or writes to the terminal. The game itself
+// lives in libdotto, which performs no console I/O
+
+void showBoard(const Board &board);
+void showScores(const std::vector<std::vector<std::string>> &scores);
+void showCoord(const std::pair<int, int> &coord);
+void showMoves(const std::map<char, std::pair<int, int>, std::less<>> &moves);
+void showSettings(const SettingsData &settings);
+void showSkippedFiles();
+
+Map getValidMap();
+PlayerType getValidPlayerType(const int playerID);
+void editSettings(SettingsData &settings);
+
+std::optional<Powerup> selectPowerup(const Player &player);
+std::optional<Piece> selectPiece(const Player &player);
+std::optional<std::pair<int, int>> selectDestination(const std::map<DirectionData, std::pair<int, int>> &moves);
+std::optional<std::pair<int, int>> selectCoord(const Board &board, const std::string &prompt, const Cell &targetCell);
+std::optional<Action> attemptMove(const Board &board, const Player &player, const bool isHop);
+std::optional<Action> selectPowerupAction(const Game &game);
+
+void applyTurnAction(Game &game, const Action &action);
+bool playComputerTurn(Game &game, TranspositionTable &table, TaskScheduler &scheduler, MctsSearcher &mctsSearcher);
+void scoreSave(const Game &game);
+void playGame(Game &game, TranspositionTable &table);
+
+#endif  // CONSOLE_H
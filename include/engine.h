@@ -0,0 +1,9 @@
+#ifndef ENGINE_H
+#define ENGINE_H
+
+#include <istream>
+#include <ostream>
+
+void runEngine(std::istream &input, std::ostream &output);
+
+#endif  // ENGINE_H
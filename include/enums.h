@@ -1,6 +1,7 @@
 #ifndef ENUMS_H
 #define ENUMS_H
 
+#include <cstddef>
 #include <string>
 
 #include "cell.h"
@@ -21,7 +22,19 @@ enum class Powerup {
     COUNT  // Variable at the end to get the number of powerups
 };
 
+inline constexpr std::size_t NUM_POWERUPS = static_cast<std::size_t>(Powerup::COUNT);
+
+enum class PlayerType {
+    HUMAN,
+    COMPUTER,  // Alpha-beta search
+    MCTS,      // Monte Carlo tree search
+
+    COUNT  // Variable at the end to get the number of player types
+};
+
 std::string mapToString(const Map &map);
+Map stringToMap(const std::string &name);
+std::string playerTypeToString(const PlayerType &playerType);
 
 std::string powerupToString(const Powerup &powerup);
 Cell powerupToCell(const Powerup &powerup);
@@ -0,0 +1,148 @@
+#ifndef EVALUATION_H
+#define EVALUATION_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
+#include "cell.h"
+#include "enums.h"
+#include "field.h"
+#include "settings_data.h"
+
+struct Player;
+
+/**
+ * @brief The features summed by the evaluation accumulator, each counted separately for both players
+ * @note The underlying value is the lane of the feature in an Accumulator
+ */
+enum class EvalFeature : std::uint8_t {
+    PLAYER_1_MATERIAL,
+    PLAYER_2_MATERIAL,
+    PLAYER_1_PLACEMENT,  // Piece-square terms, advancing and centralising pieces
+    PLAYER_2_PLACEMENT,
+    PLAYER_1_BISHOPS,
+    PLAYER_2_BISHOPS,
+    PLAYER_1_SOURCES,  // Nearness of pieces to powerup sources
+    PLAYER_2_SOURCES,
+    PLAYER_1_PORTALS,  // Pieces next to portals
+    PLAYER_2_PORTALS,
+
+    COUNT  // Variable at the end to get the number of features
+};
+
+inline constexpr std::size_t NUM_EVAL_FEATURES = static_cast<std::size_t>(EvalFeature::COUNT);
+
+// Lanes of an accumulator, the features rounded up to two AVX2 registers
+inline constexpr std::size_t EVAL_LANES = 16;
+
+static_assert(NUM_EVAL_FEATURES <= EVAL_LANES, "Every feature needs a lane of the accumulator");
+
+/**
+ * @brief A vector of weighted feature sums, one 32-bit lane per feature
+ * @note Adding and subtracting use AVX2 when it is available and fall back to a loop otherwise
+ */
+struct alignas(32) Accumulator {
+    std::array<std::int32_t, EVAL_LANES> lanes{};
+
+    /**
+     * @brief Adds another accumulator lane by lane
+     * @param other The accumulator to add
+     */
+    inline void add(const Accumulator &other) {
+#ifdef __AVX2__
+        for (std::size_t i = 0; i < EVAL_LANES; i += 8) {
+            const __m256i sum = _mm256_add_epi32(load(i), other.load(i));
+            _mm256_store_si256(reinterpret_cast<__m256i *>(lanes.data() + i), sum);
+        }
+#else
+        for (std::size_t i = 0; i < EVAL_LANES; i++) {
+            lanes[i] += other.lanes[i];
+        }
+#endif
+    }
+
+    /**
+     * @brief Subtracts another accumulator lane by lane
+     * @param other The accumulator to subtract
+     */
+    inline void subtract(const Accumulator &other) {
+#ifdef __AVX2__
+        for (std::size_t i = 0; i < EVAL_LANES; i += 8) {
+            const __m256i difference = _mm256_sub_epi32(load(i), other.load(i));
+            _mm256_store_si256(reinterpret_cast<__m256i *>(lanes.data() + i), difference);
+        }
+#else
+        for (std::size_t i = 0; i < EVAL_LANES; i++) {
+            lanes[i] -= other.lanes[i];
+        }
+#endif
+    }
+
+    /**
+     * @brief Gets the lane of a feature
+     */
+    inline std::int32_t &operator[](const EvalFeature feature) {
+        return lanes[static_cast<std::size_t>(feature)];
+    }
+
+    inline std::int32_t operator[](const EvalFeature feature) const {
+        return lanes[static_cast<std::size_t>(feature)];
+    }
+
+    bool operator==(const Accumulator &other) const = default;
+
+   private:
+#ifdef __AVX2__
+    inline __m256i load(const std::size_t offset) const {
+        return _mm256_load_si256(reinterpret_cast<const __m256i *>(lanes.data() + offset));
+    }
+#endif
+};
+
+/**
+ * @brief The weights of the evaluation, read at start up so they can be tuned without recompiling
+ */
+struct EvalWeights {
+    int piece = 100;                                         // Value of each piece
+    int bishop = 40;                                         // Extra value of a bishop
+    int advance = 2;                                         // Per row a piece has advanced from its side
+    int centre = 1;                                          // Per step a piece is from the nearest edge
+    int sourceNearness = 3;                                  // Per step closer than SOURCE_RADIUS to each source
+    int portalAdjacency = 1;                                 // Per portal next to a piece
+    std::array<int, NUM_POWERUPS> powerups = {30, 15, 20, 35};  // Value of holding each powerup, in the order of Powerup
+    int maxValuedPowerups = 2;                               // Number of each powerup worth holding
+};
+
+/**
+ * @brief Per-board tables of what each cell kind adds to the accumulator
+ * @note squares holds the terms of a kind standing on a cell on its own, and pairs the terms of a kind
+ * standing next to another kind, so a cell change only needs the cell and its eight neighbours.
+ * pairedKinds holds a bit for each kind with a nonzero pair term, so neighbours that add nothing are skipped
+ */
+struct EvalTables {
+    std::array<std::array<Accumulator, MAX_CELLS>, NUM_CELL_KINDS> squares{};
+    std::array<std::array<Accumulator, NUM_CELL_KINDS>, NUM_CELL_KINDS> pairs{};
+    std::array<std::uint16_t, NUM_CELL_KINDS> pairedKinds{};
+};
+
+// Chebyshev distance from a powerup source within which pieces count as near it
+inline constexpr int SOURCE_RADIUS = 3;
+
+// File the evaluation weights are read from, beside the executable
+extern const std::filesystem::path EVAL_WEIGHTS_PATH;
+
+EvalWeights readEvalWeights(const std::filesystem::path &path);
+const EvalWeights &getEvalWeights();
+std::shared_ptr<const EvalTables> buildEvalTables(const Field &field, const EvalWeights &weights);
+Accumulator accumulateField(const Field &field, const EvalTables &tables);
+int accumulatorScore(const Accumulator &accumulator);
+int inventoryScore(const Player &player, const EvalWeights &weights);
+
+#endif  // EVALUATION_H
@@ -0,0 +1,66 @@
+#ifndef FIELD_H
+#define FIELD_H
+
+#include <span>
+#include <utility>  // std::pair
+#include <vector>
+
+#include "cell.h"
+
+/**
+ * @brief A grid of cells stored in a single row-major buffer
+ * @note Rows are exposed as spans, so field[x][y] indexes like a nested vector
+ * without a separate allocation per row
+ */
+struct Field {
+    int length;               // Number of rows
+    int width;                // Number of columns, also the stride between rows
+    std::vector<Cell> cells;  // Row-major cell buffer of length * width cells
+
+    /**
+     * @brief Construct a new Field object filled with a single cell
+     * @param length The number of rows
+     * @param width The number of columns
+     * @param fill The cell to fill the field with
+     */
+    Field(const int length, const int width, const Cell &fill)
+        : length(length), width(width), cells(static_cast<std::size_t>(length) * width, fill) {}
+
+    /**
+     * @brief Get a view of a row of the field
+     * @param row The index of the row
+     * @return A span over the cells of the row
+     */
+    inline std::span<Cell> operator[](const int row) {
+        return {cells.data() + static_cast<std::size_t>(row) * width, static_cast<std::size_t>(width)};
+    }
+
+    /**
+     * @brief Get a read-only view of a row of the field
+     * @param row The index of the row
+     * @return A span over the cells of the row
+     */
+    inline std::span<const Cell> operator[](const int row) const {
+        return {cells.data() + static_cast<std::size_t>(row) * width, static_cast<std::size_t>(width)};
+    }
+
+    /**
+     * @brief Get the cell at a coordinate
+     * @param coord The coordinate of the cell
+     * @return A reference to the cell
+     */
+    inline Cell &at(const std::pair<int, int> &coord) {
+        return cells[static_cast<std::size_t>(coord.first) * width + coord.second];
+    }
+
+    /**
+     * @brief Get the cell at a coordinate
+     * @param coord The coordinate of the cell
+     * @return A read-only reference to the cell
+     */
+    inline const Cell &at(const std::pair<int, int> &coord) const {
+        return cells[static_cast<std::size_t>(coord.first) * width + coord.second];
+    }
+};
+
+#endif  // FIELD_H
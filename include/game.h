@@ -1,51 +1,112 @@
 #ifndef GAME_H
 #define GAME_H
 
+#include <array>
 #include <atomic>
+#include <cstdint>
 #include <filesystem>
 #include <map>
-#include <memory>
 #include <optional>
 #include <string>
 #include <utility>
 #include <vector>
 
+#include "action.h"
 #include "board.h"
+#include "enums.h"
+#include "mcts.h"
 #include "player.h"
+#include "random.h"
+#include "scheduler.h"
 #include "settings_data.h"
+#include "symmetry.h"
+#include "transposition_table.h"
+
+/**
+ * @brief Everything needed to reverse an action applied by Game::makeMove
+ */
+struct UndoRecord {
+    Action action;          // The action applied
+    Cell originCell;        // Cell at the action's origin before the action (the moved or upgraded piece)
+    Cell destinationCell;   // Cell the piece moved onto: a captured piece, a pickup or a portal
+    std::uint8_t landing;   // Cell index the piece ended on, the portal exit if it entered a portal
+    bool crumbled;          // Whether the origin was a crumbly that turned blank
+    Powerup pickup;         // Powerup picked up at the destination, Powerup::COUNT if none
+};
+
+// Number of undo records reserved up front, so makeMove does not allocate during a search
+inline constexpr std::size_t MAX_HISTORY = 512;
+
+// CellInfo::portalPartner of a cell without a portal
+inline constexpr std::uint8_t NO_PORTAL = 255;
+
+/**
+ * @brief Per-cell facts that are not visible from the cell drawn on the board
+ */
+struct CellInfo {
+    std::uint8_t portalPartner = NO_PORTAL;  // Cell index of the other end of the portal on this cell
+    bool isCrumbly = false;                  // Whether the cell crumbles into a blank when a piece leaves it
+    bool isPowerupSource = false;            // Whether the cell is a powerup source
+};
+
+/**
+ * @brief An action chosen for a computer player
+ */
+struct ComputerChoice {
+    Action action;       // The action to play
+    std::string reason;  // How it was chosen, e.g. "depth 8, score 12, 200000 nodes in 0.50s, 400000 nodes/s"
+};
 
 struct Game {
     const SettingsData settings;                              // Settings of the game
     Board board;                                              // Game board
-    const std::shared_ptr<Player> player1;                    // Player 1
-    const std::shared_ptr<Player> player2;                    // Player 2
-    std::set<std::pair<int, int>> crumbliesCoords;            // Crumblies coordinates
-    const std::set<std::pair<int, int>> powerupSourceCoords;  // Powerup source coordinates
-    std::set<std::pair<int, int>> barrierCoords;              // Barrier coordinates
-    std::set<Portal> portals{};                               // Portal objects
+    Player player1;                                           // Player 1
+    Player player2;                                           // Player 2
+    std::array<CellInfo, MAX_CELLS> cellInfo{};               // Crumbly, source and portal facts per cell index
+    std::array<std::uint64_t, NUM_SYMMETRIES> portalHashes{};  // Zobrist hash of the portal pairs under each symmetry
+    bool hasPowerupSources{};                                 // Whether the board has any powerup sources
+    std::vector<UndoRecord> history{};                        // Undo records of actions applied by makeMove
 
     int turnNumber{1};       // Current turn number
     int currentPlayerID{1};  // Current player's ID
 
     explicit Game(const SettingsData &settingsData);
 
-    std::optional<std::pair<int, int>> editCoord(const std::string &prompt, const Cell &targetCell, const Cell &newCell);
     std::pair<int, int> updatePortals(const std::pair<int, int> &coord);
-    void processMove(const std::pair<int, int> &origin, std::pair<int, int> &destination);
+    void movePiece(const std::pair<int, int> &origin, const std::pair<int, int> &destination, UndoRecord &record);
+    void unmovePiece(const UndoRecord &record);
+    void addPortal(const std::pair<int, int> &coord_1, const std::pair<int, int> &coord_2);
+    void togglePortalHashes(const int index_1, const int index_2);
+    void removePortal(const std::pair<int, int> &coord_1, const std::pair<int, int> &coord_2);
+    void makeMove(const Action &action);
+    void applyAction(const Action &action, UndoRecord &record);
+    void unmakeMove();
+    std::string describeAction(const Action &action) const;
+
+    bool isCrumbly(const std::pair<int, int> &coord) const;
+    bool isPowerupSource(const std::pair<int, int> &coord) const;
+    std::optional<std::pair<int, int>> getPortalPartner(const std::pair<int, int> &coord) const;
 
     bool checkDefeat() const;
-    bool usePowerup();
-    void scoreSave() const;
-    void placePowerup();
-    void play();
+    std::optional<std::pair<int, int>> placePowerup(Random &random = Random::getInstance());
+    void placePowerup(const std::pair<int, int> &coord, const Powerup powerup);
+    bool placesPowerups() const;
+    PlayerType getPlayerType() const;
+    std::optional<ComputerChoice> chooseComputerAction(TranspositionTable &table, TaskScheduler &scheduler, MctsSearcher &mctsSearcher);
 
     const Cell &getTargetCell() const;
     const Cell &getTargetBishopCell() const;
     const Cell &getAllyCell() const;
     const Cell &getAllyBishopCell() const;
 
-    const std::shared_ptr<Player> &getTargetPlayer() const;
-    const std::shared_ptr<Player> &getAllyPlayer() const;
+    Player &getTargetPlayer();
+    Player &getAllyPlayer();
+    const Player &getTargetPlayer() const;
+    const Player &getAllyPlayer() const;
+
+    std::uint64_t positionHash() const;
+    std::uint64_t symmetricHash(const Symmetry symmetry) const;
+    CanonicalKey canonicalKey() const;
 };
 
 #endif  // GAME_H
\ No newline at end of file
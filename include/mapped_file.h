@@ -0,0 +1,37 @@
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <vector>
+
+/**
+ * @brief A read-only view of a whole file, memory mapped where the platform supports it
+ * @note Mapping means opening a file reads nothing, and only the pages that are used are read from
+ * disk. Elsewhere the file is read into memory. The data is aligned for any fundamental type
+ */
+class MappedFile {
+   public:
+    explicit MappedFile(const std::filesystem::path &path);
+    ~MappedFile();
+
+    inline const std::byte *data() const {
+        return bytes;
+    }
+
+    inline std::size_t size() const {
+        return numBytes;
+    }
+
+   private:
+    const std::byte *bytes = nullptr;
+    std::size_t numBytes = 0;
+    void *mapping = nullptr;
+    std::vector<std::uint64_t> contents;  // The file read into memory where it cannot be mapped
+
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+};
+
+#endif  // MAPPED_FILE_H
@@ -0,0 +1,83 @@
+#ifndef MCTS_H
+#define MCTS_H
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <vector>
+
+#include "action.h"
+#include "arena.h"
+
+struct Game;
+
+/**
+ * @brief Expansion states of an MctsNode
+ */
+enum class NodeState : std::uint8_t {
+    UNEXPANDED,  // Children not created yet
+    EXPANDING,   // A thread is creating the children
+    EXPANDED,    // Children created, numChildren is 0 for a finished game
+    FULL         // The arena ran out of room, the node stays a leaf
+};
+
+/**
+ * @brief A node of the Monte Carlo search tree, shared by every search thread
+ * @note children and numChildren are written once by the thread that expands the node and
+ * published by storing EXPANDED into state, so readers must load state before reading them.
+ * score is in half points (2 for a win, 1 for a draw) from the view of the player who made action
+ */
+struct MctsNode {
+    Action action;
+    std::atomic<NodeState> state{NodeState::UNEXPANDED};
+    std::uint32_t numChildren = 0;
+    std::atomic<std::int32_t> visits{0};
+    std::atomic<std::int32_t> score{0};
+    MctsNode *children = nullptr;
+};
+
+/**
+ * @brief Limits on a single Monte Carlo search
+ */
+struct MctsLimits {
+    double seconds;               // Time to search for
+    int threads;                  // Number of threads searching the shared tree
+    std::size_t treeMegabytes;    // Memory for tree nodes, shared between the threads
+};
+
+/**
+ * @brief The outcome of a Monte Carlo search
+ */
+struct MctsResult {
+    std::optional<Action> bestAction;  // Most visited action, std::nullopt if there are no legal actions
+    double winRate = 0.0;              // Expected score of the best action, 0 for a loss and 1 for a win
+    std::uint64_t playouts = 0;        // Number of playouts run by every thread
+    double seconds = 0.0;              // Time spent searching
+
+    double playoutsPerSecond() const;
+};
+
+/**
+ * @brief Parallel Monte Carlo tree search using tree parallelism with virtual loss
+ * @note Every thread descends the same tree, adding a virtual loss to each node it passes so other
+ * threads spread out over different branches, and plays its playouts on its own copy of the game.
+ * Nodes come from per-thread arenas that are released together when the next search starts.
+ * Powerup placements are sampled as the game would make them, so the tree is open loop: a child
+ * whose action needs a powerup the current sample does not hold is skipped
+ */
+class MctsSearcher {
+   public:
+    MctsResult search(const Game &game, const MctsLimits &limits);
+
+   private:
+    std::vector<std::unique_ptr<Arena>> arenas;  // One per thread, kept between searches
+    std::atomic<bool> stopped{false};
+
+    void runThread(const Game &rootGame, MctsNode &root, Arena &arena,
+                   const std::chrono::steady_clock::time_point deadline, std::uint64_t &playouts);
+};
+
+#endif  // MCTS_H
@@ -0,0 +1,17 @@
+#ifndef MOVE_GENERATOR_H
+#define MOVE_GENERATOR_H
+
+#include <cstddef>
+
+#include "action.h"
+#include "board.h"
+#include "game.h"
+#include "player.h"
+
+std::size_t firstSlideVector(const bool isBishop, const bool isHop);
+void generatePieceMoves(const Board &board, const Player &player, const bool isHop, ActionList &actions);
+void generateActions(const Game &game, ActionList &actions);
+void generateNoisyActions(const Game &game, ActionList &actions);
+bool isNoisy(const Game &game, const Action &action);
+
+#endif  // MOVE_GENERATOR_H
@@ -0,0 +1,31 @@
+#ifndef NOTATION_H
+#define NOTATION_H
+
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#include "action.h"
+#include "board.h"
+#include "enums.h"
+
+/**
+ * @brief A powerup placed on a powerup source, which is not an action of either player
+ */
+struct Placement {
+    std::pair<int, int> coord;
+    Powerup powerup;
+};
+
+// Actions are written as one word with coordinates as shown on the board, e.g. "3B": a move is its
+// origin and destination ("1A1C"), a hop, portal, destroyer or bishop upgrade is prefixed with
+// 'h', 'p', 'd' or 'b' ("h1A3A", "p2B4D", "d3C", "b1A"), and a powerup placement is written as
+// '+', the source coordinate and the powerup's cell character ("+3CH")
+
+std::string actionToString(const Board &board, const Action &action);
+std::optional<Action> stringToAction(const Board &board, std::string_view text);
+std::string placementToString(const Placement &placement);
+std::optional<Placement> stringToPlacement(const Board &board, std::string_view text);
+
+#endif  // NOTATION_H
@@ -0,0 +1,101 @@
+#ifndef OPENING_BOOK_H
+#define OPENING_BOOK_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <optional>
+#include <ostream>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "action.h"
+#include "enums.h"
+#include "mapped_file.h"
+
+struct Game;
+
+// Identifies opening book files, followed by the format version
+inline constexpr std::array<char, 8> BOOK_MAGIC = {'D', 'O', 'T', 'T', 'O', 'B', 'K', '\0'};
+inline constexpr std::uint32_t BOOK_VERSION = 3;
+
+// Directory opening books are written to and read from, beside the executable
+extern const std::filesystem::path BOOK_DIRECTORY;
+
+/**
+ * @brief The header at the start of an opening book file, followed by its entries sorted by hash then action
+ * @note Files are written in the byte order of the machine that generated them
+ */
+struct BookHeader {
+    std::array<char, 8> magic;
+    std::uint32_t version;
+    std::uint32_t padding;
+    std::uint64_t numEntries;
+};
+
+/**
+ * @brief The self-play statistics of an action played from a position
+ */
+struct BookEntry {
+    std::uint64_t hash;        // Game::canonicalKey of the position the action was played from
+    std::uint32_t games;       // Games in which the action was played from the position
+    std::uint32_t halfPoints;  // Score of the player who played it over those games, 2 for a win and 1 for a draw
+    ActionType type;  // The action, turned into the canonical position
+    std::uint8_t origin;
+    std::uint8_t target;
+    std::uint8_t padding[5];
+
+    inline Action action() const {
+        return {type, origin, target};
+    }
+
+    inline double scoreRate() const {
+        return games > 0 ? halfPoints / (2.0 * games) : 0.0;
+    }
+};
+
+static_assert(sizeof(BookEntry) == 24, "Book entries are stored on disk as they are laid out in memory");
+
+/**
+ * @brief An opening book file, memory mapped and searched in place so opening it reads nothing
+ */
+class OpeningBook {
+   public:
+    explicit OpeningBook(const std::filesystem::path &path);
+
+    std::span<const BookEntry> probe(const std::uint64_t hash) const;
+
+   private:
+    MappedFile file;
+    const BookEntry *entries = nullptr;
+    std::size_t numEntries = 0;
+};
+
+/**
+ * @brief Every opening book found in BOOK_DIRECTORY
+ */
+class OpeningBookSet {
+   public:
+    explicit OpeningBookSet(const std::filesystem::path &directory);
+
+    std::optional<BookEntry> choose(const Game &game) const;
+
+    /**
+     * @brief Gets why each file that looked like an opening book was skipped, for front ends to report
+     */
+    inline const std::vector<std::string> &getSkipped() const {
+        return skipped;
+    }
+
+   private:
+    std::vector<std::unique_ptr<OpeningBook>> books;
+    std::vector<std::string> skipped;
+};
+
+const OpeningBookSet &getOpeningBooks();
+std::filesystem::path buildOpeningBook(const Map &map, const int numGames, const int threads, std::ostream &log);
+
+#endif  // OPENING_BOOK_H
@@ -12,6 +12,8 @@
 #include "board.h"
 #include "cell.h"
 #include "enums.h"
+#include "field.h"
+#include "random.h"
 
 std::string coordToString(const std::pair<int, int> &coord);
 std::pair<int, int> stringToCoord(const std::string &coordString);
@@ -22,16 +24,12 @@ std::vector<std::vector<T>> import2DTemplate(const std::filesystem::path &path,
 std::vector<std::vector<std::string>> import2D(const std::filesystem::path &path);
 std::vector<std::vector<char>> importChar2D(const std::filesystem::path &path);
 
-std::vector<std::vector<Cell>> readMap(const Map &map);
+Field readMap(const Map &map);
 
 void export2D(const std::filesystem::path &path, const std::vector<std::vector<std::string>> &data);
-void showScores(const std::vector<std::vector<std::string>> &scores);
-void showCoord(const std::pair<int, int> &coord);
-void showMoves(const std::map<char, std::pair<int, int>, std::less<>> &moves);
 std::string verboseCoord(const std::pair<int, int> &coord);
 
-Map getValidMap();
-Powerup generateRandomPowerup();
+Powerup generateRandomPowerup(Random &random = Random::getInstance());
 
 // template functions must be defined in the header file
 
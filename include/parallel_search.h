@@ -0,0 +1,34 @@
+#ifndef PARALLEL_SEARCH_H
+#define PARALLEL_SEARCH_H
+
+#include <memory>
+#include <optional>
+#include <vector>
+
+#include "game.h"
+#include "scheduler.h"
+#include "search.h"
+#include "transposition_table.h"
+
+/**
+ * @brief Alpha-beta search with the root split over the workers of a TaskScheduler
+ * @note Each iteration uses Young Brothers Wait at the root: the first (eldest) action is searched
+ * alone to get a bound, then every other action becomes a task that idle workers steal. Each worker
+ * has its own searcher and copy of the game, and they share the transposition table, the node
+ * budget and a cancellation token, so the whole search stops soon after any limit is reached
+ */
+class ParallelSearcher {
+   public:
+    ParallelSearcher(TaskScheduler &scheduler, TranspositionTable &table);
+
+    SearchResult search(const Game &game, const SearchLimits &limits);
+
+   private:
+    TaskScheduler &scheduler;
+    TranspositionTable &table;
+    SharedSearchState shared;
+    std::vector<std::unique_ptr<Searcher>> searchers;  // One per worker
+    std::vector<std::optional<Game>> games;            // One per worker
+};
+
+#endif  // PARALLEL_SEARCH_H
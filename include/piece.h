@@ -1,16 +1,18 @@
 #ifndef PIECE_H
 #define PIECE_H
 
+#include <cstdint>
 #include <optional>
 #include <set>
-#include <string>
+#include <string_view>
+#include <type_traits>
 #include <utility>  // std::pair
 
 #include "cell.h"
 
 struct DirectionData {
     const char key;
-    const std::string name;
+    const std::string_view name;
     std::pair<int, int> vector;
     std::optional<std::pair<int, int>> destination = std::nullopt;
 
@@ -19,19 +21,33 @@ struct DirectionData {
     }
 };
 
+/**
+ * @brief A player's dot, stored in four bytes so a player's pieces can be copied as plain memory
+ */
 struct Piece {
-    std::pair<int, int> coord;
+    std::int8_t row;     // Row of the piece's coordinate
+    std::int8_t column;  // Column of the piece's coordinate
     Cell cell;
     bool isBishop;
 
+    Piece() = default;
     Piece(const std::pair<int, int> &coord, const Cell &cell, const bool isBishop);
     void updatePosition(const std::pair<int, int> &newCoord);
     void bishopUpgrade(const Cell &bishopCell);
     std::set<DirectionData> getDirections(const bool isHop) const;
 
+    /**
+     * @brief Gets the coordinate of the piece
+     */
+    inline std::pair<int, int> coord() const {
+        return {row, column};
+    }
+
     bool operator<(const Piece &other) const {
-        return coord < other.coord;
+        return coord() < other.coord();
     }
 };
 
+static_assert(std::is_trivially_copyable_v<Piece>);
+
 #endif  // PIECE_H
\ No newline at end of file
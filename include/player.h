@@ -1,47 +1,67 @@
 #ifndef PLAYER_H
 #define PLAYER_H
 
+#include <array>
+#include <cstdint>
 #include <map>
 #include <optional>
-#include <set>
+#include <span>
 #include <string>
+#include <type_traits>
 #include <vector>
 
 #include "board.h"
 #include "cell.h"
 #include "enums.h"
 #include "piece.h"
+#include "settings_data.h"
 
+// Maximum number of pieces a player can have
+inline constexpr int MAX_PIECES = 32;
+
+// Entry of Player::pieceIndex for cells without a piece
+inline constexpr std::uint8_t NO_PIECE = 255;
+
+/**
+ * @brief A player, with fixed capacity storage so it is trivially copyable and never allocates
+ * @note Pieces are kept densely in the first numPieces slots of pieces, and pieceIndex maps
+ * each board cell to the slot of the piece on it, so finding, moving and removing a piece is O(1).
+ * The inventory holds a count of each powerup
+ */
 struct Player {
-    const int id;
-    const Cell cell;
-    const Cell bishopCell;
+    int id;
+    Cell cell;
+    Cell bishopCell;
 
-    std::set<Piece> pieces = {};
-    std::vector<Powerup> inventory = {};
+    std::array<Piece, MAX_PIECES> pieces{};
+    int numPieces = 0;
+    std::array<std::array<std::uint8_t, MAX_BOARD_WIDTH>, MAX_BOARD_LENGTH> pieceIndex{};
+    std::array<std::uint8_t, NUM_POWERUPS> inventory{};
+    std::uint64_t inventoryHash = 0;         // Zobrist hash of the inventory, kept in sync with the inventory
+    std::uint64_t swappedInventoryHash = 0;  // Zobrist hash of the inventory held by the other player, for symmetries that swap colours
 
-    Player(const int id, const Cell &cell, const Cell &bishopCell, const std::set<Piece> &pieces);
+    Player(const int id, const Cell &cell, const Cell &bishopCell, const std::vector<Piece> &pieces);
     void addPowerup(const Powerup &powerup);
     void removePowerup(const Powerup &powerup);
     void addPiece(const Piece &piece);
     void removePiece(const Piece &piece);
     void removePiece(const std::pair<int, int> &coord);
-    void updatePiece(Piece &piece, const std::pair<int, int> &newCoord);
-    void updatePiece(const std::pair<int, int> &coord, std::pair<int, int> &newCoord);
+    void updatePiece(const std::pair<int, int> &coord, const std::pair<int, int> &newCoord);
 
+    std::span<const Piece> getPieces() const;
+    const Piece *getPiece(const std::pair<int, int> &coord) const;
+    int getPowerupCount(const Powerup &powerup) const;
     bool hasPowerup(const Powerup &powerup) const;
     bool hasPowerups() const;
-    std::optional<Powerup> selectPowerup() const;
-
-    std::optional<Piece> selectPiece() const;
     std::optional<std::pair<int, int>> getDestination(const Board &board,
                                                       const std::pair<int, int> &origin,
                                                       const std::pair<int, int> &vector) const;
     std::map<DirectionData, std::pair<int, int>> detectMoves(const Board &board, const Piece &piece, const bool isHop) const;
 
-    std::optional<std::pair<int, int>> selectDestination(const std::map<DirectionData, std::pair<int, int>> &moves) const;
-    std::optional<std::pair<std::pair<int, int>, std::pair<int, int>>> attemptMove(const Board &board, const bool isHop) const;
     bool upgradePiece(const Piece &piece);
+    void downgradePiece(const std::pair<int, int> &coord);
 };
 
+static_assert(std::is_trivially_copyable_v<Player>);
+
 #endif  // PLAYER_H
\ No newline at end of file
@@ -0,0 +1,136 @@
+#ifndef PROOF_SEARCH_H
+#define PROOF_SEARCH_H
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <optional>
+#include <ostream>
+#include <vector>
+
+#include "action.h"
+#include "enums.h"
+#include "scheduler.h"
+
+struct Game;
+class TablebaseSet;
+
+// Proof and disproof numbers of a solved position
+inline constexpr std::uint32_t PROOF_INFINITY = UINT32_MAX;
+
+// Deepest ply the proof search descends to, positions deeper count as the attacker failing
+inline constexpr int MAX_PROOF_PLY = 1000;
+
+/**
+ * @brief Proof and disproof numbers from the point of view of the player to move
+ * @note phi is the proof number if the attacker is to move and the disproof number otherwise, and
+ * delta the other. phi is 0 once the player to move is known to win and delta is 0 once they are
+ * known to lose. A position never searched is worth 1 and 1
+ */
+struct ProofNumbers {
+    std::uint32_t phi = 1;
+    std::uint32_t delta = 1;
+
+    inline bool isSolved() const {
+        return phi == 0 || delta == 0;
+    }
+};
+
+/**
+ * @brief One slot of the proof table
+ */
+struct ProofSlot {
+    std::uint64_t key = 0;
+    ProofNumbers numbers;
+    std::uint32_t work = 0;       // Nodes searched below the position, the slot with the least is replaced first
+    std::uint16_t searchers = 0;  // Threads currently searching below the position
+};
+
+/**
+ * @brief A cache line of slots guarded by a spin lock
+ */
+struct alignas(64) ProofCluster {
+    std::atomic_flag lock;
+    std::array<ProofSlot, 2> slots;
+};
+
+/**
+ * @brief A fixed size hash table of proof and disproof numbers shared by every proof search thread
+ * @note Memory is only allocated by the constructor. When a cluster is full the position that took
+ * the least work to search is replaced, so solved positions deep in the proof survive longest
+ */
+class ProofTable {
+   public:
+    explicit ProofTable(const std::size_t megabytes);
+
+    void clear();
+    ProofNumbers probe(const std::uint64_t hash, std::uint16_t *searchers = nullptr);
+    void store(const std::uint64_t hash, const ProofNumbers &numbers, const std::uint64_t work);
+    void enter(const std::uint64_t hash);
+    void leave(const std::uint64_t hash);
+
+   private:
+    std::unique_ptr<ProofCluster[]> clusters;
+    std::size_t numClusters = 0;
+
+    inline ProofCluster &cluster(const std::uint64_t hash) const {
+        // numClusters is a power of two, so the low bits of the hash pick the cluster
+        return clusters[hash & (numClusters - 1)];
+    }
+    ProofSlot &findSlot(ProofCluster &cluster, const std::uint64_t hash);
+
+    ProofTable(const ProofTable &) = delete;
+    ProofTable &operator=(const ProofTable &) = delete;
+};
+
+/**
+ * @brief Whether the attacker of a proof search can force a win
+ */
+enum class ProofResult {
+    PROVEN,     // The attacker wins whatever the defender plays
+    DISPROVEN,  // The defender can stop the attacker winning
+    UNKNOWN     // The node limit was reached first
+};
+
+/**
+ * @brief The outcome of a proof search
+ */
+struct ProofSearchResult {
+    ProofResult result = ProofResult::UNKNOWN;
+    std::optional<Action> winningAction;  // The attacker's first winning action if they are to move and win
+    std::uint64_t nodes = 0;
+    double seconds = 0.0;
+};
+
+/**
+ * @brief Depth-first proof-number (df-pn) search of whether one player can force a win
+ * @note Only games without powerup placement are deterministic, so only those can be solved. Every
+ * worker runs the same depth-first search from the root and they share the proof table. A worker
+ * counts each position other workers are searching as harder than it looks, so the workers spread
+ * over different parts of the tree. Solved tablebase positions are leaves of the search.
+ * Positions are keyed over the symmetries that keep the colours, so reflected positions share their
+ * numbers. The colour swapping symmetries are left out, as they swap the attacker and the defender
+ * and the numbers depend on which of them is to move. A position repeated on the path, or a
+ * reflection of one, counts as the attacker failing. Proofs do
+ * not depend on the path and are exact, but a disproof stored in the table may have relied on a
+ * repetition of a path the position was reached by, so disproofs mean the attacker failed to find a
+ * win rather than that no win exists
+ */
+class ProofSearcher {
+   public:
+    ProofSearcher(TaskScheduler &scheduler, ProofTable &table);
+
+    ProofSearchResult solve(const Game &game, const int attacker, const std::uint64_t maxNodes);
+
+   private:
+    TaskScheduler &scheduler;
+    ProofTable &table;
+    const TablebaseSet &tablebases;
+};
+
+void solveMap(const Map &map, const std::uint64_t maxNodes, const int threads, const std::size_t megabytes, std::ostream &out);
+
+#endif  // PROOF_SEARCH_H
@@ -2,22 +2,73 @@
 #define RANDOM_H
 
 #include <algorithm>  // std::shuffle
-#include <random>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <iterator>  // std::next
 #include <ranges>
 #include <set>
 #include <vector>
 
 /**
- * @brief A class to generate random numbers using the Mersenne Twister algorithm
+ * @brief The xoshiro256** generator: 256 bits of state and a few shifts and rotations per number
+ * @note Satisfies std::uniform_random_bit_generator, so it can be passed to the standard algorithms
+ */
+struct Xoshiro256 {
+    using result_type = std::uint64_t;
+
+    std::array<std::uint64_t, 4> state{};
+
+    void seed(std::uint64_t value);
+
+    static constexpr result_type min() {
+        return 0;
+    }
+
+    static constexpr result_type max() {
+        return UINT64_MAX;
+    }
+
+    /**
+     * @brief Gets the next 64 random bits
+     */
+    inline result_type operator()() {
+        const std::uint64_t result = rotateLeft(state[1] * 5, 7) * 9;
+        const std::uint64_t shifted = state[1] << 17;
+        state[2] ^= state[0];
+        state[3] ^= state[1];
+        state[1] ^= state[2];
+        state[0] ^= state[3];
+        state[2] ^= shifted;
+        state[3] = rotateLeft(state[3], 45);
+        return result;
+    }
+
+   private:
+    static constexpr std::uint64_t rotateLeft(const std::uint64_t value, const int bits) {
+        return (value << bits) | (value >> (64 - bits));
+    }
+};
+
+/**
+ * @brief A class to generate random numbers using the xoshiro256** algorithm
  * and avoids repeated code for random number generation
+ * @note Each thread has its own instance, seeded from std::random_device unless a fixed seed is set,
+ * in which case every generator created afterwards is seeded from the fixed seed and runs are reproducible
  */
 class Random {
    public:
     Random();
+    explicit Random(std::uint64_t value);
 
+    void seed(std::uint64_t value);
     int getInt(int min, int max);
     float getFloat(float min, float max);
 
+    static void setFixedSeed(std::uint64_t value);
+    static std::uint64_t freshSeed();
+    static std::uint64_t deriveSeed(std::uint64_t seed, std::uint64_t stream);
+
     /**
      * @brief Shuffle a vector
      * @tparam T The type of the elements
@@ -31,40 +82,45 @@ class Random {
     /**
      * @brief Get a random element from a vector
      * @tparam T The type of the elements
-     * @param elements The vector of elements
+     * @param elements The vector of elements, which must not be empty
      * @return A random element
      */
     template <typename T>
-    T getRandomElement(const std::vector<T>& elements) {
-        return elements[getInt(0, elements.size() - 1)];
+    const T& getRandomElement(const std::vector<T>& elements) {
+        return elements[getInt(0, static_cast<int>(elements.size()) - 1)];
     }
 
     /**
      * @brief Get a random element from a set
      * @tparam T The type of the elements
-     * @param elements The set of elements
+     * @param elements The set of elements, which must not be empty
      * @return A random element
+     * @note Walks to the element rather than copying the set into a vector
      */
     template <typename T>
-    T getRandomElement(const std::set<T>& elements) {
-        // Convert to vector and call the other function
-        std::vector<T> vec(elements.begin(), elements.end());
-        return getRandomElement(vec);
+    const T& getRandomElement(const std::set<T>& elements) {
+        return *std::next(elements.begin(), getInt(0, static_cast<int>(elements.size()) - 1));
     }
 
-    // Public method to get singleton instance
+    // Public method to get the calling thread's instance
     // static so it is only defined ONCE in the program
     static Random& getInstance();
 
    private:
-    std::mt19937 generator;  // Mersenne Twister random number generator
+    Xoshiro256 generator;
 
     // Delete copy constructor and assignment operator to prevent copying
     Random(const Random&) = delete;
     Random& operator=(const Random&) = delete;
 
-    // define static member variable for the singleton instance
-    static Random instance;
+    // define static member variable for the singleton instance, one per thread so
+    // search threads never share a generator
+    static thread_local Random instance;
+
+    // The fixed seed set by setFixedSeed, and the number of seeds handed out from it so far
+    static std::atomic<bool> isSeedFixed;
+    static std::atomic<std::uint64_t> fixedSeed;
+    static std::atomic<std::uint64_t> fixedStreams;
 };
 
-#endif  // RANDOM_H
\ No newline at end of file
+#endif  // RANDOM_H
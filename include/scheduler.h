@@ -0,0 +1,105 @@
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "random.h"
+
+/**
+ * @brief A flag that asks running tasks to stop, which they check for themselves
+ */
+class CancellationToken {
+   public:
+    inline void cancel() {
+        cancelled.store(true, std::memory_order_relaxed);
+    }
+
+    inline void reset() {
+        cancelled.store(false, std::memory_order_relaxed);
+    }
+
+    inline bool isCancelled() const {
+        return cancelled.load(std::memory_order_relaxed);
+    }
+
+   private:
+    std::atomic<bool> cancelled{false};
+};
+
+/**
+ * @brief The worker a task runs on
+ */
+struct Worker {
+    int index;       // 0 for the thread that owns the scheduler, 1 to size() - 1 for its threads
+    Random &random;  // The worker's own generator, so tasks never share one
+};
+
+/**
+ * @brief A set of tasks that can be waited on together
+ */
+class TaskGroup {
+   public:
+    inline bool done() const {
+        return pending.load(std::memory_order_acquire) == 0;
+    }
+
+   private:
+    std::atomic<int> pending{0};
+
+    friend class TaskScheduler;
+};
+
+using Task = std::function<void(Worker &)>;
+
+/**
+ * @brief A work-stealing scheduler running tasks on a fixed set of worker threads
+ * @note Every worker has its own deque. A worker pushes and pops tasks at the back of its own deque,
+ * so the most recently split work stays on the thread that has it in cache, and idle workers steal
+ * from the front of other deques, taking the oldest and so usually largest piece of work.
+ * The thread that creates the scheduler is worker 0 and runs tasks while it waits, so a scheduler of
+ * size 1 runs everything on the calling thread. Only worker threads and the owning thread may spawn tasks
+ */
+class TaskScheduler {
+   public:
+    TaskScheduler(const int numWorkers, const std::uint32_t seed);
+    ~TaskScheduler();
+
+    int size() const;
+    void spawn(TaskGroup &group, Task task);
+    void wait(TaskGroup &group);
+
+   private:
+    struct Entry {
+        Task task;
+        TaskGroup *group;
+    };
+
+    struct WorkerQueue {
+        std::mutex mutex;
+        std::deque<Entry> tasks;
+    };
+
+    std::vector<std::unique_ptr<WorkerQueue>> queues;
+    std::vector<std::thread> threads;
+    Random ownerRandom;  // Worker 0's generator, seeded like the others rather than taken from the owning thread
+    std::atomic<int> queuedTasks{0};  // Tasks waiting in any deque, so idle workers know when to wake
+    std::atomic<bool> shuttingDown{false};
+    std::mutex sleepMutex;
+    std::condition_variable wakeUp;
+
+    bool runOne(Worker &worker);
+    void workerLoop(const int index, const std::uint32_t seed);
+
+    TaskScheduler(const TaskScheduler &) = delete;
+    TaskScheduler &operator=(const TaskScheduler &) = delete;
+};
+
+#endif  // SCHEDULER_H
@@ -0,0 +1,113 @@
+#ifndef SEARCH_H
+#define SEARCH_H
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+#include "action.h"
+#include "scheduler.h"
+#include "symmetry.h"
+#include "transposition_table.h"
+
+struct Game;
+struct TablebaseEntry;
+class TablebaseSet;
+
+// Score of a won position, reduced by the number of plies needed to win so faster wins score higher
+inline constexpr int MATE_SCORE = 1000000;
+
+// Scores beyond this are wins or losses rather than evaluations
+inline constexpr int MATE_BOUND = MATE_SCORE - 1000;
+
+// Plies quiescence search may search beyond the nominal depth
+inline constexpr int MAX_QUIESCENCE_PLIES = 16;
+
+/**
+ * @brief Limits on a single search, whichever is reached first ends it
+ */
+struct SearchLimits {
+    int maxDepth;             // Deepest iteration to run, in plies
+    std::uint64_t maxNodes;   // Number of nodes to visit before stopping
+    double maxSeconds = 0.0;  // Time to search for, 0 for no time limit
+};
+
+/**
+ * @brief State shared by every searcher taking part in one parallel search
+ */
+struct SharedSearchState {
+    CancellationToken cancellation;       // Cancelled once any limit is reached
+    std::atomic<std::uint64_t> nodes{0};  // Nodes visited by every searcher, counted in batches
+};
+
+/**
+ * @brief The outcome of a search
+ */
+struct SearchResult {
+    std::optional<Action> bestAction;  // Best action found, std::nullopt if there are no legal actions
+    int score = 0;                     // Score of the best action from the searching player's view
+    int depth = 0;                     // Depth of the last completed iteration
+    std::uint64_t nodes = 0;           // Number of nodes visited
+    double seconds = 0.0;              // Time spent searching
+
+    double nodesPerSecond() const;
+};
+
+/**
+ * @brief Iterative deepening negamax search with alpha-beta pruning
+ * @note The search plays actions on the game with makeMove and takes them back with unmakeMove,
+ * so the game is left unchanged once it returns. Action lists are allocated once per ply
+ * and reused, so the search itself does not allocate. Results are shared through a transposition
+ * table, which any number of searchers can use at once. Searchers that share a SharedSearchState
+ * count their nodes together and all stop once any of them is cancelled.
+ * Actions are tried in order of the hash action, captures, powerup pickups, killers and then
+ * history, and leaves are extended with a quiescence search of captures and pickups.
+ * Positions in the endgame tablebases are scored from them without being searched
+ */
+class Searcher {
+   public:
+    explicit Searcher(TranspositionTable &table, SharedSearchState *shared = nullptr);
+
+    SearchResult search(Game &game, const SearchLimits &limits);
+    void prepare(const SearchLimits &limits);
+    int searchAction(Game &game, const Action &action, const int depth, const int alpha, const int beta);
+    void orderActions(const Game &game, ActionList &actions, const std::optional<Action> &hashAction);
+    std::optional<SearchResult> probeRoot(Game &game, const ActionList &rootActions) const;
+    bool isStopped() const;
+    std::uint64_t getNodes() const;
+
+   private:
+    TranspositionTable &table;            // Results of previously searched positions
+    const TablebaseSet &tablebases;       // Solved endgames
+    SharedSearchState *shared;            // Limits shared with other searchers, nullptr when searching alone
+    std::vector<ActionList> actionLists;  // Actions of each ply, reused between nodes
+    std::vector<std::vector<int>> actionScores;                  // Ordering scores of each ply's actions
+    std::vector<std::array<std::optional<Action>, 2>> killers;  // Quiet actions that caused a cutoff at each ply
+    std::vector<int> historyScores;                              // How well each quiet move of each player has done
+    std::uint64_t nodes = 0;
+    std::uint64_t maxNodes = 0;
+    std::optional<std::chrono::steady_clock::time_point> deadline;
+    bool stopped = false;
+
+    void countNode();
+    int negamax(Game &game, int depth, int alpha, int beta, const int ply);
+    int quiescence(Game &game, int alpha, int beta, const int ply);
+    void scoreActions(const Game &game, const ActionList &actions, std::vector<int> &scores,
+                      const std::optional<Action> &hashAction, const int ply) const;
+    void recordCutoff(const Game &game, const Action &action, const int depth, const int ply);
+    static std::size_t historyIndex(const Game &game, const Action &action);
+    int searchRoot(Game &game, const int depth, ActionList &rootActions, Action &bestAction);
+};
+
+int evaluate(const Game &game);
+int tablebaseScore(const TablebaseEntry &entry, const int ply);
+void moveToFront(ActionList &actions, const Action &action);
+std::optional<TableEntry> probeCanonical(const TranspositionTable &table, const Game &game, const CanonicalKey &key, const int ply);
+void storeCanonical(TranspositionTable &table, const Game &game, const CanonicalKey &key, TableEntry entry, const int ply);
+void pruneSymmetricActions(const Game &game, ActionList &actions);
+
+#endif  // SEARCH_H
@@ -3,25 +3,49 @@
 
 #include "enums.h"
 
+// Bounds on the board dimensions that can be chosen in the settings
+inline constexpr int MIN_BOARD_LENGTH = 5;
+inline constexpr int MAX_BOARD_LENGTH = 15;
+inline constexpr int MIN_BOARD_WIDTH = 5;
+inline constexpr int MAX_BOARD_WIDTH = 15;
+inline constexpr int MAX_CELLS = MAX_BOARD_LENGTH * MAX_BOARD_WIDTH;
+
+// Bounds on the computer player's search limits
+inline constexpr int MAX_SEARCH_DEPTH = 32;
+inline constexpr int MIN_SEARCH_NODES = 1000;
+inline constexpr int MAX_SEARCH_NODES = 100000000;
+inline constexpr int MIN_TABLE_MEGABYTES = 1;
+inline constexpr int MAX_TABLE_MEGABYTES = 65536;
+inline constexpr int MAX_SEARCH_THREADS = 256;
+inline constexpr int MIN_THINK_MILLISECONDS = 10;
+inline constexpr int MAX_THINK_MILLISECONDS = 600000;
+
 struct SettingsData {
     Map map = Map::RANDOM;
     int length = 5;
     int width = 5;
     int numDots = 3;
     int numInitialPowerups = 3;
-    int powerupPlacementFrequency = 3;
+    int powerupPlacementFrequency = 3;  // Turns between powerup placements, 0 to never place powerups
     int numInitialCrumblies = 3;
     int barrierDensity = 4;
     int numDeletes = 3;
     int numCreates = 3;
+    PlayerType player1Type = PlayerType::HUMAN;
+    PlayerType player2Type = PlayerType::HUMAN;
+    int searchDepth = 8;         // Maximum depth of the computer player's search
+    int searchNodes = 200000;    // Maximum number of nodes the computer player searches per move
+    int tableMegabytes = 64;     // Size of the computer player's transposition table
+    bool useHugePages = false;   // Whether to back the transposition table with huge pages (Linux only)
+    int searchThreads = 1;       // Number of threads the computer player searches with
+    int thinkMilliseconds = 1000;  // Time the Monte Carlo computer player searches per move
 
     /**
      * @brief Construct a new Settings Data object
      */
     SettingsData() = default;
 
-    void edit();
-    void tabulate() const;
+    bool operator==(const SettingsData &other) const = default;
 };
 
 #endif  // SETTINGS_DATA_H
\ No newline at end of file
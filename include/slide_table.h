@@ -0,0 +1,113 @@
+#ifndef SLIDE_TABLE_H
+#define SLIDE_TABLE_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <utility>  // std::pair
+
+#include "bitboard.h"
+#include "board_geometry.h"
+#include "settings_data.h"
+
+// Every vector a piece can move along: orthogonal and diagonal steps, then their hop equivalents
+inline constexpr std::array<std::pair<int, int>, 16> SLIDE_VECTORS = {{{-1, 0}, {0, -1}, {1, 0}, {0, 1},
+                                                                        {-1, 1}, {-1, -1}, {1, -1}, {1, 1},
+                                                                        {-2, 0}, {0, -2}, {2, 0}, {0, 2},
+                                                                        {-2, 2}, {-2, -2}, {2, -2}, {2, 2}}};
+inline constexpr std::size_t NUM_SLIDE_VECTORS = SLIDE_VECTORS.size();
+
+// Stopping square of a slide that leaves the board
+inline constexpr std::uint8_t NO_STOP = 255;
+
+static_assert(MAX_CELLS < NO_STOP, "Cell indices must fit in a byte alongside NO_STOP");
+
+/**
+ * @brief Gets the index of a vector in SLIDE_VECTORS
+ * @param vector The vector to find
+ * @return The index of the vector, or NUM_SLIDE_VECTORS if it is not a slide vector
+ */
+constexpr std::size_t slideVectorIndex(const std::pair<int, int> &vector) {
+    for (std::size_t i = 0; i < NUM_SLIDE_VECTORS; i++) {
+        if (SLIDE_VECTORS[i] == vector) {
+            return i;
+        }
+    }
+    return NUM_SLIDE_VECTORS;
+}
+
+/**
+ * @brief Precomputed stopping squares of a dot sliding over blank cells
+ * @note stops[v][i] is the first non-blank cell reached from cell i by repeatedly adding
+ * SLIDE_VECTORS[v], or NO_STOP if the slide leaves the board first. The table only depends
+ * on which cells are blank, so it only needs patching when a cell becomes or stops being blank
+ */
+struct SlideTable {
+    std::array<std::array<std::uint8_t, MAX_CELLS>, NUM_SLIDE_VECTORS> stops{};
+
+    /**
+     * @brief Gets the stopping square of a slide
+     * @param vectorIndex The index of the vector in SLIDE_VECTORS
+     * @param index The cell index the slide starts from
+     * @return The cell index the slide stops at, or NO_STOP
+     */
+    inline std::uint8_t stop(const std::size_t vectorIndex, const int index) const {
+        return stops[vectorIndex][index];
+    }
+
+    /**
+     * @brief Fills the whole table
+     * @param geometry The geometry of the board
+     * @param blankPlane The plane of blank cells
+     */
+    template <typename Geometry>
+    void build(const Geometry &geometry, const Bitboard &blankPlane) {
+        for (std::size_t v = 0; v < NUM_SLIDE_VECTORS; v++) {
+            for (int i = 0; i < geometry.length * geometry.width; i++) {
+                stops[v][i] = walk(geometry, blankPlane, toCoord(geometry, i), SLIDE_VECTORS[v]);
+            }
+        }
+    }
+
+    /**
+     * @brief Patches the table after a cell became blank or stopped being blank
+     * @param geometry The geometry of the board
+     * @param blankPlane The plane of blank cells, already updated
+     * @param changed The coordinate of the changed cell
+     * @note Only the cells whose slides run through the changed cell are recomputed
+     */
+    template <typename Geometry>
+    void update(const Geometry &geometry, const Bitboard &blankPlane, const std::pair<int, int> &changed) {
+        for (std::size_t v = 0; v < NUM_SLIDE_VECTORS; v++) {
+            const auto [dx, dy] = SLIDE_VECTORS[v];
+            // Walk backwards from the changed cell, the nearest cell first so each step can reuse the one after it
+            std::pair<int, int> coord = {changed.first - dx, changed.second - dy};
+            while (isWithinBounds(geometry, coord)) {
+                const int next = toIndex(geometry, {coord.first + dx, coord.second + dy});
+                const int index = toIndex(geometry, coord);
+                stops[v][index] = blankPlane.test(next) ? stops[v][next] : static_cast<std::uint8_t>(next);
+                // Slides from further back only pass through the changed cell if they pass through this one
+                if (!blankPlane.test(index)) {
+                    break;
+                }
+                coord = {coord.first - dx, coord.second - dy};
+            }
+        }
+    }
+
+   private:
+    /**
+     * @brief Walks from a cell until a non-blank cell or the edge of the board is reached
+     */
+    template <typename Geometry>
+    static std::uint8_t walk(const Geometry &geometry, const Bitboard &blankPlane,
+                             const std::pair<int, int> &origin, const std::pair<int, int> &vector) {
+        std::pair<int, int> coord = {origin.first + vector.first, origin.second + vector.second};
+        while (isWithinBounds(geometry, coord) && blankPlane.test(toIndex(geometry, coord))) {
+            coord = {coord.first + vector.first, coord.second + vector.second};
+        }
+        return isWithinBounds(geometry, coord) ? static_cast<std::uint8_t>(toIndex(geometry, coord)) : NO_STOP;
+    }
+};
+
+#endif  // SLIDE_TABLE_H
@@ -0,0 +1,19 @@
+#ifndef SPLIT_MIX_H
+#define SPLIT_MIX_H
+
+#include <cstdint>
+
+/**
+ * @brief Advances a SplitMix64 state and returns the next value
+ * @param state The state to advance
+ * @return A 64-bit pseudo-random value
+ * @note Used to generate the Zobrist keys and to spread seeds over a generator's state
+ */
+constexpr std::uint64_t splitMix64(std::uint64_t &state) {
+    std::uint64_t value = (state += 0x9E3779B97F4A7C15ULL);
+    value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    value = (value ^ (value >> 27)) * 0x94D049BB133111EBULL;
+    return value ^ (value >> 31);
+}
+
+#endif  // SPLIT_MIX_H
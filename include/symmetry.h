@@ -0,0 +1,111 @@
+#ifndef SYMMETRY_H
+#define SYMMETRY_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <utility>  // std::swap
+
+#include "action.h"
+#include "cell.h"
+#include "settings_data.h"
+
+/**
+ * @brief The transformations of a position that leave the game unchanged
+ * @note Pieces move the same way in every direction, so a position played on the field turned 180
+ * degrees with the players' colours swapped and the other player to move is the same game, as
+ * rotateField uses to generate maps. Reflecting the field left to right keeps the rows, so it needs
+ * no swap. Only positions whose transformed terrain matches their own, such as those of
+ * point-symmetric maps, ever share a key with a transformed position
+ */
+enum class Symmetry : std::uint8_t {
+    IDENTITY,            // The position itself
+    ROTATION,            // Turned 180 degrees with the colours swapped
+    REFLECTION,          // Reflected left to right
+    ROTATED_REFLECTION,  // Reflected top to bottom with the colours swapped
+
+    COUNT  // Variable at the end to get the number of symmetries
+};
+
+inline constexpr std::size_t NUM_SYMMETRIES = static_cast<std::size_t>(Symmetry::COUNT);
+
+/**
+ * @brief Checks if a symmetry swaps the players' colours, and so the player to move
+ */
+constexpr bool swapsColours(const Symmetry symmetry) {
+    return symmetry == Symmetry::ROTATION || symmetry == Symmetry::ROTATED_REFLECTION;
+}
+
+/**
+ * @brief Gets the cell a symmetry turns a cell into
+ */
+constexpr Cell transformCell(const Cell &cell, const Symmetry symmetry) {
+    if (!swapsColours(symmetry)) {
+        return cell;
+    }
+    if (cell == PLAYER_1_CELL) {
+        return PLAYER_2_CELL;
+    } else if (cell == PLAYER_2_CELL) {
+        return PLAYER_1_CELL;
+    } else if (cell == BISHOP_1_CELL) {
+        return BISHOP_2_CELL;
+    } else if (cell == BISHOP_2_CELL) {
+        return BISHOP_1_CELL;
+    }
+    return cell;
+}
+
+/**
+ * @brief The cell index each symmetry moves each cell of a board to
+ * @note Every symmetry is its own inverse, so the same table maps keys to and from the canonical position
+ */
+struct SymmetryTable {
+    std::array<std::array<std::uint8_t, MAX_CELLS>, NUM_SYMMETRIES> indices{};  // [symmetry][cell index]
+
+    /**
+     * @brief Fills the table for a board
+     * @param length The number of rows of the board
+     * @param width The number of columns of the board
+     */
+    void build(const int length, const int width) {
+        for (int row = 0; row < length; row++) {
+            for (int column = 0; column < width; column++) {
+                const int index = row * width + column;
+                indices[static_cast<std::size_t>(Symmetry::IDENTITY)][index] = static_cast<std::uint8_t>(index);
+                indices[static_cast<std::size_t>(Symmetry::ROTATION)][index] = static_cast<std::uint8_t>(length * width - 1 - index);
+                indices[static_cast<std::size_t>(Symmetry::REFLECTION)][index] = static_cast<std::uint8_t>(row * width + width - 1 - column);
+                indices[static_cast<std::size_t>(Symmetry::ROTATED_REFLECTION)][index] = static_cast<std::uint8_t>((length - 1 - row) * width + column);
+            }
+        }
+    }
+
+    inline int transform(const int index, const Symmetry symmetry) const {
+        return indices[static_cast<std::size_t>(symmetry)][index];
+    }
+
+    /**
+     * @brief Gets the action a symmetry turns an action into
+     * @note Only moves, hops and portals use their target, and portal ends are kept in ascending
+     * order as generateActions lists them
+     */
+    inline Action transform(const Action &action, const Symmetry symmetry) const {
+        Action transformed{action.type, static_cast<std::uint8_t>(transform(action.origin, symmetry)), action.target};
+        if (action.type == ActionType::MOVE || action.type == ActionType::HOP || action.type == ActionType::PORTAL) {
+            transformed.target = static_cast<std::uint8_t>(transform(action.target, symmetry));
+        }
+        if (action.type == ActionType::PORTAL && transformed.origin > transformed.target) {
+            std::swap(transformed.origin, transformed.target);
+        }
+        return transformed;
+    }
+};
+
+/**
+ * @brief A hash shared by a position and every position a symmetry turns it into
+ */
+struct CanonicalKey {
+    std::uint64_t hash;  // The smallest hash of the position under any symmetry
+    Symmetry symmetry;   // The symmetry that turns the position into the one hashed
+};
+
+#endif  // SYMMETRY_H
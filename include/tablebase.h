@@ -0,0 +1,168 @@
+#ifndef TABLEBASE_H
+#define TABLEBASE_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <optional>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "bitboard.h"
+#include "enums.h"
+#include "field.h"
+#include "mapped_file.h"
+#include "settings_data.h"
+
+struct Board;
+struct Game;
+struct Player;
+
+// Most dots per side a tablebase can hold, more would not fit in memory on any board
+inline constexpr int MAX_TABLEBASE_DOTS = 4;
+
+// Identifies tablebase files, followed by the format version
+inline constexpr std::array<char, 8> TABLEBASE_MAGIC = {'D', 'O', 'T', 'T', 'O', 'T', 'B', '\0'};
+inline constexpr std::uint32_t TABLEBASE_VERSION = 1;
+
+// Entries store the distance in their low bits and the result in the two bits above
+inline constexpr int TABLEBASE_DISTANCE_BITS = 14;
+inline constexpr int MAX_TABLEBASE_DISTANCE = (1 << TABLEBASE_DISTANCE_BITS) - 1;
+
+// Directory tablebases are written to and read from, beside the executable
+extern const std::filesystem::path TABLEBASE_DIRECTORY;
+
+/**
+ * @brief The outcome of a tablebase position with best play, for the player to move
+ */
+enum class TablebaseResult : std::uint8_t {
+    DRAW,    // Neither player can force a win, also the value of unsolved entries while generating
+    WIN,
+    LOSS,
+    INVALID  // The position cannot occur, two pieces share a cell or the player not to move has none
+};
+
+/**
+ * @brief A solved position
+ */
+struct TablebaseEntry {
+    TablebaseResult result;
+    int distance;  // Plies until the game ends, with the winner winning as fast and the loser losing as slowly as they can
+};
+
+/**
+ * @brief The header at the start of a tablebase file, followed by one std::uint16_t entry per position
+ * @note Files are written in the byte order of the machine that generated them
+ */
+struct TablebaseHeader {
+    std::array<char, 8> magic;
+    std::uint32_t version;
+    std::uint8_t length;   // Rows of the board
+    std::uint8_t width;    // Columns of the board
+    std::uint8_t maxDots;  // Most dots of each side
+    std::uint8_t padding;
+    std::uint64_t numPositions;
+    std::array<std::uint64_t, 4> blank;    // Words of the blank plane of the terrain the tablebase was solved on
+    std::array<std::uint64_t, 4> barrier;  // Words of its barrier plane, every other cell is one a piece can stand on
+};
+
+/**
+ * @brief A set of a side's pieces, as stored in a tablebase
+ */
+struct SideConfig {
+    int count = 0;
+    std::array<std::uint8_t, MAX_TABLEBASE_DOTS> cells{};  // Cell indices of the pieces, in ascending order
+    std::uint8_t bishops = 0;                              // Bit i is set if the piece on cells[i] is a bishop
+    Bitboard occupied{};
+};
+
+/**
+ * @brief Maps positions of up to maxDots pieces per side on a fixed terrain to dense indices
+ * @note A side's pieces are ranked with the combinatorial number system over the cells a piece can
+ * stand on, times the bishop flags of the pieces. A position's index is then
+ * (sideToMove * numConfigs + player1Config) * numConfigs + player2Config
+ */
+class TablebaseIndex {
+   public:
+    TablebaseIndex(const int numCells, const Bitboard &blank, const Bitboard &barrier, const int maxDots);
+
+    std::uint32_t rankConfig(const SideConfig &config) const;
+    std::optional<std::uint32_t> rankPlayer(const Board &board, const Player &player) const;
+    std::vector<SideConfig> listConfigs() const;
+
+    /**
+     * @brief Gets the index of a position
+     * @param sideToMove 0 if player 1 is to move, 1 if player 2 is
+     */
+    inline std::uint64_t position(const int sideToMove, const std::uint32_t player1Config, const std::uint32_t player2Config) const {
+        return (static_cast<std::uint64_t>(sideToMove) * numConfigs + player1Config) * numConfigs + player2Config;
+    }
+
+    inline std::uint32_t getNumConfigs() const {
+        return numConfigs;
+    }
+
+    inline std::uint64_t getNumPositions() const {
+        return 2 * static_cast<std::uint64_t>(numConfigs) * numConfigs;
+    }
+
+   private:
+    int maxDots;
+    std::vector<std::uint8_t> cells;                            // Cells a piece can stand on, in ascending order
+    std::array<std::uint8_t, MAX_CELLS> cellRanks{};            // Position of each cell in cells
+    std::vector<std::array<std::uint32_t, MAX_TABLEBASE_DOTS + 1>> binomials;  // binomials[n][k] is n choose k
+    std::array<std::uint32_t, MAX_TABLEBASE_DOTS + 2> offsets{};  // First rank of the configs of each piece count
+    std::uint32_t numConfigs = 0;
+};
+
+/**
+ * @brief A tablebase file, memory mapped so only the pages that are probed are read from disk
+ */
+class Tablebase {
+   public:
+    explicit Tablebase(const std::filesystem::path &path);
+
+    std::optional<TablebaseEntry> probe(const Game &game) const;
+
+   private:
+    MappedFile file;
+    const TablebaseHeader *header = nullptr;
+    const std::uint16_t *entries = nullptr;
+    std::unique_ptr<TablebaseIndex> index;
+};
+
+/**
+ * @brief Every tablebase found in TABLEBASE_DIRECTORY
+ */
+class TablebaseSet {
+   public:
+    explicit TablebaseSet(const std::filesystem::path &directory);
+
+    std::optional<TablebaseEntry> probe(const Game &game) const;
+
+    inline bool empty() const {
+        return tablebases.empty();
+    }
+
+    /**
+     * @brief Gets why each file that looked like a tablebase was skipped, for front ends to report
+     */
+    inline const std::vector<std::string> &getSkipped() const {
+        return skipped;
+    }
+
+   private:
+    std::vector<std::unique_ptr<Tablebase>> tablebases;
+    std::vector<std::string> skipped;
+};
+
+TablebaseEntry decodeTablebaseEntry(const std::uint16_t data);
+std::uint16_t encodeTablebaseEntry(const TablebaseEntry &entry);
+bool isTablebasePosition(const Game &game);
+const TablebaseSet &getTablebases();
+std::filesystem::path generateTablebase(const Map &map, const int maxDots, const int threads, std::ostream &log);
+
+#endif  // TABLEBASE_H
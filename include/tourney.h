@@ -0,0 +1,86 @@
+#ifndef TOURNEY_H
+#define TOURNEY_H
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "enums.h"
+
+/**
+ * @brief How one side of a tournament chooses its actions
+ */
+struct PlayerConfig {
+    PlayerType type = PlayerType::COMPUTER;  // COMPUTER for alpha-beta or MCTS
+    int depth = 8;                           // Deepest alpha-beta iteration
+    std::uint64_t nodes = 200000;            // Alpha-beta nodes per action
+    int milliseconds = 0;                    // Time per action, 0 for none with alpha-beta (MCTS needs one)
+    std::size_t tableMegabytes = 16;         // Transposition table, or MCTS tree, of each worker
+
+    std::string describe() const;
+};
+
+PlayerConfig parsePlayerConfig(const std::string &spec);
+
+/**
+ * @brief The hypotheses of a sequential probability ratio test on the Elo difference
+ */
+struct SprtBounds {
+    double elo0 = 0.0;   // Elo difference of the null hypothesis
+    double elo1 = 5.0;   // Elo difference of the alternative hypothesis
+    double alpha = 0.05; // Chance of accepting elo1 when elo0 is true
+    double beta = 0.05;  // Chance of accepting elo0 when elo1 is true
+
+    double lower() const;
+    double upper() const;
+};
+
+/**
+ * @brief An Elo difference with the half width of its 95% confidence interval
+ */
+struct EloEstimate {
+    double elo;
+    double margin;
+};
+
+/**
+ * @brief The results of the first configuration against the second
+ */
+struct TourneyScore {
+    int wins = 0;
+    int draws = 0;
+    int losses = 0;
+
+    inline int games() const {
+        return wins + draws + losses;
+    }
+
+    double scoreRate() const;
+    double scoreVariance() const;
+    EloEstimate elo() const;
+    double logLikelihoodRatio(const SprtBounds &bounds) const;
+};
+
+/**
+ * @brief Everything that defines a tournament
+ */
+struct TourneyOptions {
+    PlayerConfig first;                  // Configuration "A", whose score is reported
+    PlayerConfig second;                 // Configuration "B"
+    int games = 1000;                    // Games to play unless the SPRT stops early, rounded up to pairs
+    int threads = 1;                     // Games played at once
+    std::uint64_t seed = 1;              // Seed every game's map, opening and placements derive from
+    std::vector<Map> maps{Map::BREAKOUT};  // Maps the pairs of games cycle through
+    int randomPlies = 2;                 // Random plies played at the start of every game
+    int maxPlies = 400;                  // Plies after which a game is a draw
+    bool useSprt = false;                // Whether to stop as soon as the SPRT accepts a hypothesis
+    SprtBounds sprt;
+    std::filesystem::path output = "tourney.csv";  // File each game's result is appended to
+};
+
+TourneyScore runTourney(const TourneyOptions &options, std::ostream &log);
+
+#endif  // TOURNEY_H
@@ -0,0 +1,76 @@
+#ifndef TRANSPOSITION_TABLE_H
+#define TRANSPOSITION_TABLE_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+
+#include "action.h"
+
+/**
+ * @brief How a stored score relates to the true score of a position
+ */
+enum class Bound : std::uint8_t {
+    NONE,   // Empty entry
+    EXACT,  // The score is exact
+    LOWER,  // The search failed high, the true score is at least the score
+    UPPER   // The search failed low, the true score is at most the score
+};
+
+/**
+ * @brief A search result unpacked from the transposition table
+ */
+struct TableEntry {
+    int score;
+    int depth;
+    Bound bound;
+    std::optional<Action> bestAction;
+};
+
+/**
+ * @brief One slot of the table, two words written and read without locking
+ * @note keyXorData holds the position's hash XORed with data. A reader that sees the words of two
+ * different writes recovers the wrong key and treats the slot as a miss, so torn entries are never used
+ */
+struct TableSlot {
+    std::atomic<std::uint64_t> keyXorData{0};
+    std::atomic<std::uint64_t> data{0};
+};
+
+/**
+ * @brief A fixed size hash table of search results shared by every search thread without a mutex
+ * @note Memory is only allocated by resize, so probing and storing never allocate.
+ * On Linux the memory can be backed by transparent huge pages to reduce TLB misses
+ */
+class TranspositionTable {
+   public:
+    TranspositionTable() = default;
+    TranspositionTable(const std::size_t megabytes, const bool useHugePages);
+    ~TranspositionTable();
+
+    void resize(const std::size_t megabytes, const bool useHugePages);
+    void clear();
+    std::optional<TableEntry> probe(const std::uint64_t hash, const int ply) const;
+    void store(const std::uint64_t hash, const TableEntry &entry, const int ply);
+    std::size_t size() const;
+    int hashfull() const;
+
+   private:
+    TableSlot *slots = nullptr;
+    std::size_t numSlots = 0;
+    std::size_t allocatedBytes = 0;
+    bool mapped = false;  // Whether slots was allocated with mmap rather than operator new
+
+    void release();
+    inline TableSlot &slot(const std::uint64_t hash) const {
+        // numSlots is a power of two, so the low bits of the hash pick the slot
+        return slots[hash & (numSlots - 1)];
+    }
+
+    // The table is owned by one place and shared by reference
+    TranspositionTable(const TranspositionTable &) = delete;
+    TranspositionTable &operator=(const TranspositionTable &) = delete;
+};
+
+#endif  // TRANSPOSITION_TABLE_H
@@ -0,0 +1,88 @@
+#ifndef ZOBRIST_H
+#define ZOBRIST_H
+
+#include <array>
+#include <bit>  // std::rotl
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+#include "cell.h"
+#include "enums.h"
+#include "settings_data.h"
+#include "split_mix.h"
+
+// Number of inventory counts per powerup with their own key, every count a player's std::uint8_t slot can hold
+inline constexpr std::size_t ZOBRIST_INVENTORY_COUNTS = std::numeric_limits<std::uint8_t>::max() + 1;
+
+/**
+ * @brief Random keys used to hash a game position
+ * @note A position hash is the XOR of the keys of its parts, so each part can be updated
+ * in O(1) by XORing out its old key and XORing in its new one
+ */
+struct ZobristKeys {
+    std::array<std::array<std::uint64_t, MAX_CELLS>, NUM_CELL_KINDS> cells{};                                // [kind][cell index]
+    std::array<std::array<std::array<std::uint64_t, ZOBRIST_INVENTORY_COUNTS>, NUM_POWERUPS>, 2> inventory{};  // [player][powerup][count]
+    std::array<std::uint64_t, MAX_CELLS> portals{};                                                           // [cell index]
+    std::uint64_t sideToMove{};                                                                               // Player 2 to move
+};
+
+/**
+ * @brief Generates the Zobrist keys from a fixed seed at compile time
+ * @return The keys
+ * @note A count of zero always has a key of zero, so an empty inventory contributes nothing to the hash
+ */
+consteval ZobristKeys buildZobristKeys() {
+    ZobristKeys keys;
+    std::uint64_t state = 0x446F74746F2D4850ULL;
+    for (auto &kindKeys : keys.cells) {
+        for (auto &key : kindKeys) {
+            key = splitMix64(state);
+        }
+    }
+    for (auto &playerKeys : keys.inventory) {
+        for (auto &powerupKeys : playerKeys) {
+            for (std::size_t count = 1; count < ZOBRIST_INVENTORY_COUNTS; count++) {
+                powerupKeys[count] = splitMix64(state);
+            }
+        }
+    }
+    for (auto &key : keys.portals) {
+        key = splitMix64(state);
+    }
+    keys.sideToMove = splitMix64(state);
+    return keys;
+}
+
+inline constexpr ZobristKeys ZOBRIST_KEYS = buildZobristKeys();
+
+/**
+ * @brief Gets the key of a cell kind at a cell index
+ */
+constexpr std::uint64_t cellKey(const Cell &cell, const int index) {
+    return ZOBRIST_KEYS.cells[cell.index()][index];
+}
+
+/**
+ * @brief Gets the key of a player holding a number of a powerup
+ * @param playerID The ID of the player (1 or 2)
+ * @param powerup The powerup held
+ * @param count The number held, at most the largest count Player::addPowerup allows
+ */
+constexpr std::uint64_t inventoryKey(const int playerID, const Powerup &powerup, const std::size_t count) {
+    return ZOBRIST_KEYS.inventory[playerID - 1][static_cast<std::size_t>(powerup)][count];
+}
+
+/**
+ * @brief Gets the key of a portal pair, independent of the order of its ends
+ * @param index_1 The cell index of one end of the portal
+ * @param index_2 The cell index of the other end of the portal
+ */
+constexpr std::uint64_t portalKey(const int index_1, const int index_2) {
+    const int low = index_1 < index_2 ? index_1 : index_2;
+    const int high = index_1 < index_2 ? index_2 : index_1;
+    // Rotating the second key keeps a pair distinct from the same two cells in other pairs
+    return ZOBRIST_KEYS.portals[low] ^ std::rotl(ZOBRIST_KEYS.portals[high], 23);
+}
+
+#endif  // ZOBRIST_H
@@ -0,0 +1,702 @@
+#include "batch_playout.h"
+
+#include <algorithm>  // std::min
+#include <bit>        // std::countr_zero, std::popcount
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+#if defined(__AVX512F__) || defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+#include "cell.h"
+#include "enums.h"
+#include "game.h"
+#include "player.h"
+#include "random.h"
+#include "settings_data.h"
+#include "slide_table.h"
+
+// Games advanced by one SIMD instruction: 16 with AVX-512, otherwise 8 (AVX2 or the portable fallback).
+// Kept out of the header, as it depends on the instruction set this file is compiled for
+#ifdef __AVX512F__
+constexpr int PLAYOUT_LANES = 16;
+#else
+constexpr int PLAYOUT_LANES = 8;
+#endif
+
+static_assert(std::has_single_bit(static_cast<unsigned>(PLAYOUT_LANES)), "Lanes must be a power of two");
+
+// Cell offsets in a block are cell * PLAYOUT_LANES + lane
+constexpr int LANE_SHIFT = std::countr_zero(static_cast<unsigned>(PLAYOUT_LANES));
+
+// Bytes a 32-bit gather of the last byte of a table reads past its end
+constexpr std::size_t GATHER_PADDING = sizeof(std::int32_t) - 1;
+
+// Random bits compared to accept a candidate with probability 1 / count, so count << RESERVOIR_BITS fits in an int
+constexpr int RESERVOIR_BITS = 23;
+
+/**
+ * @brief Builds the index of every lane, 0 to PLAYOUT_LANES - 1
+ */
+consteval std::array<std::int32_t, PLAYOUT_LANES> buildLaneIndices() {
+    std::array<std::int32_t, PLAYOUT_LANES> indices{};
+    for (int lane = 0; lane < PLAYOUT_LANES; lane++) {
+        indices[lane] = lane;
+    }
+    return indices;
+}
+
+alignas(64) constexpr std::array<std::int32_t, PLAYOUT_LANES> LANE_INDICES = buildLaneIndices();
+
+#if defined(__AVX512F__)
+/**
+ * @brief Operations on one 32-bit value per lane, with AVX-512 and its mask registers
+ */
+struct Lanes {
+    using Vector = __m512i;
+    using Mask = __mmask16;
+
+    // Mask of every lane, for the zero-masked forms used where GCC 12's plain forms start from an
+    // undefined vector, which optimised builds report as maybe uninitialised
+    static constexpr Mask ALL_LANES = 0xFFFF;
+
+    static inline Vector set(const int value) {
+        return _mm512_set1_epi32(value);
+    }
+
+    static inline Vector load(const std::int32_t *values) {
+        return _mm512_loadu_si512(values);
+    }
+
+    static inline Vector loadBytes(const std::uint8_t *bytes) {
+        return _mm512_maskz_cvtepu8_epi32(ALL_LANES, _mm_loadu_si128(reinterpret_cast<const __m128i *>(bytes)));
+    }
+
+    static inline void store(std::int32_t *values, const Vector vector) {
+        _mm512_storeu_si512(values, vector);
+    }
+
+    static inline Vector add(const Vector a, const Vector b) {
+        return _mm512_add_epi32(a, b);
+    }
+
+    static inline Vector multiply(const Vector a, const Vector b) {
+        return _mm512_mullo_epi32(a, b);
+    }
+
+    static inline Vector bitXor(const Vector a, const Vector b) {
+        return _mm512_xor_si512(a, b);
+    }
+
+    template <int Shift>
+    static inline Vector shiftLeft(const Vector a) {
+        return _mm512_maskz_slli_epi32(ALL_LANES, a, Shift);
+    }
+
+    template <int Shift>
+    static inline Vector shiftRight(const Vector a) {
+        return _mm512_maskz_srli_epi32(ALL_LANES, a, Shift);
+    }
+
+    static inline Mask equal(const Vector a, const Vector b) {
+        return _mm512_cmpeq_epi32_mask(a, b);
+    }
+
+    static inline Mask less(const Vector a, const Vector b) {
+        return _mm512_cmplt_epi32_mask(a, b);
+    }
+
+    static inline Mask both(const Mask a, const Mask b) {
+        return static_cast<Mask>(a & b);
+    }
+
+    static inline Mask either(const Mask a, const Mask b) {
+        return static_cast<Mask>(a | b);
+    }
+
+    static inline Mask without(const Mask a, const Mask b) {
+        return static_cast<Mask>(a & ~b);
+    }
+
+    static inline Mask none() {
+        return 0;
+    }
+
+    static inline Mask fromBits(const std::uint32_t bits) {
+        return static_cast<Mask>(bits);
+    }
+
+    static inline bool any(const Mask mask) {
+        return mask != 0;
+    }
+
+    /**
+     * @brief Takes a where the mask is set and b elsewhere
+     */
+    static inline Vector select(const Mask mask, const Vector a, const Vector b) {
+        return _mm512_mask_blend_epi32(mask, b, a);
+    }
+
+    /**
+     * @brief Reads the byte at each lane's offset from a table, keeping the fallback where the mask is clear
+     */
+    static inline Vector gatherBytes(const std::uint8_t *table, const Vector offsets, const Mask mask, const Vector fallback) {
+        const Vector words = _mm512_mask_i32gather_epi32(fallback, mask, offsets, table, 1);
+        return select(mask, _mm512_and_si512(words, set(0xFF)), fallback);
+    }
+};
+#elif defined(__AVX2__)
+/**
+ * @brief Operations on one 32-bit value per lane, with AVX2 and all-ones lanes as masks
+ */
+struct Lanes {
+    using Vector = __m256i;
+    using Mask = __m256i;
+
+    static inline Vector set(const int value) {
+        return _mm256_set1_epi32(value);
+    }
+
+    static inline Vector load(const std::int32_t *values) {
+        return _mm256_loadu_si256(reinterpret_cast<const __m256i *>(values));
+    }
+
+    static inline Vector loadBytes(const std::uint8_t *bytes) {
+        return _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i *>(bytes)));
+    }
+
+    static inline void store(std::int32_t *values, const Vector vector) {
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(values), vector);
+    }
+
+    static inline Vector add(const Vector a, const Vector b) {
+        return _mm256_add_epi32(a, b);
+    }
+
+    static inline Vector multiply(const Vector a, const Vector b) {
+        return _mm256_mullo_epi32(a, b);
+    }
+
+    static inline Vector bitXor(const Vector a, const Vector b) {
+        return _mm256_xor_si256(a, b);
+    }
+
+    template <int Shift>
+    static inline Vector shiftLeft(const Vector a) {
+        return _mm256_slli_epi32(a, Shift);
+    }
+
+    template <int Shift>
+    static inline Vector shiftRight(const Vector a) {
+        return _mm256_srli_epi32(a, Shift);
+    }
+
+    static inline Mask equal(const Vector a, const Vector b) {
+        return _mm256_cmpeq_epi32(a, b);
+    }
+
+    static inline Mask less(const Vector a, const Vector b) {
+        return _mm256_cmpgt_epi32(b, a);
+    }
+
+    static inline Mask both(const Mask a, const Mask b) {
+        return _mm256_and_si256(a, b);
+    }
+
+    static inline Mask either(const Mask a, const Mask b) {
+        return _mm256_or_si256(a, b);
+    }
+
+    static inline Mask without(const Mask a, const Mask b) {
+        return _mm256_andnot_si256(b, a);
+    }
+
+    static inline Mask none() {
+        return _mm256_setzero_si256();
+    }
+
+    static inline Mask fromBits(const std::uint32_t bits) {
+        const Vector laneBits = _mm256_sllv_epi32(set(1), load(LANE_INDICES.data()));
+        return equal(_mm256_and_si256(set(static_cast<int>(bits)), laneBits), laneBits);
+    }
+
+    static inline bool any(const Mask mask) {
+        return !_mm256_testz_si256(mask, mask);
+    }
+
+    /**
+     * @brief Takes a where the mask is set and b elsewhere
+     */
+    static inline Vector select(const Mask mask, const Vector a, const Vector b) {
+        return _mm256_blendv_epi8(b, a, mask);
+    }
+
+    /**
+     * @brief Reads the byte at each lane's offset from a table, keeping the fallback where the mask is clear
+     */
+    static inline Vector gatherBytes(const std::uint8_t *table, const Vector offsets, const Mask mask, const Vector fallback) {
+        const Vector words = _mm256_mask_i32gather_epi32(fallback, reinterpret_cast<const int *>(table), offsets, mask, 1);
+        return select(mask, _mm256_and_si256(words, set(0xFF)), fallback);
+    }
+};
+#else
+/**
+ * @brief Operations on one 32-bit value per lane, as plain loops for targets without AVX2
+ */
+struct Lanes {
+    using Vector = std::array<std::int32_t, PLAYOUT_LANES>;
+    using Mask = std::uint32_t;
+
+    template <typename Function>
+    static inline Vector build(Function &&function) {
+        Vector vector;
+        for (int lane = 0; lane < PLAYOUT_LANES; lane++) {
+            vector[lane] = function(lane);
+        }
+        return vector;
+    }
+
+    template <typename Function>
+    static inline Mask test(Function &&function) {
+        Mask mask = 0;
+        for (int lane = 0; lane < PLAYOUT_LANES; lane++) {
+            mask |= static_cast<Mask>(function(lane)) << lane;
+        }
+        return mask;
+    }
+
+    static inline Vector set(const int value) {
+        return build([value](int) { return value; });
+    }
+
+    static inline Vector load(const std::int32_t *values) {
+        return build([values](const int lane) { return values[lane]; });
+    }
+
+    static inline Vector loadBytes(const std::uint8_t *bytes) {
+        return build([bytes](const int lane) { return static_cast<std::int32_t>(bytes[lane]); });
+    }
+
+    static inline void store(std::int32_t *values, const Vector &vector) {
+        std::copy(vector.begin(), vector.end(), values);
+    }
+
+    static inline Vector add(const Vector &a, const Vector &b) {
+        return build([&a, &b](const int lane) { return a[lane] + b[lane]; });
+    }
+
+    static inline Vector multiply(const Vector &a, const Vector &b) {
+        return build([&a, &b](const int lane) { return a[lane] * b[lane]; });
+    }
+
+    static inline Vector bitXor(const Vector &a, const Vector &b) {
+        return build([&a, &b](const int lane) { return a[lane] ^ b[lane]; });
+    }
+
+    template <int Shift>
+    static inline Vector shiftLeft(const Vector &a) {
+        return build([&a](const int lane) { return static_cast<std::int32_t>(static_cast<std::uint32_t>(a[lane]) << Shift); });
+    }
+
+    template <int Shift>
+    static inline Vector shiftRight(const Vector &a) {
+        return build([&a](const int lane) { return static_cast<std::int32_t>(static_cast<std::uint32_t>(a[lane]) >> Shift); });
+    }
+
+    static inline Mask equal(const Vector &a, const Vector &b) {
+        return test([&a, &b](const int lane) { return a[lane] == b[lane]; });
+    }
+
+    static inline Mask less(const Vector &a, const Vector &b) {
+        return test([&a, &b](const int lane) { return a[lane] < b[lane]; });
+    }
+
+    static inline Mask both(const Mask a, const Mask b) {
+        return a & b;
+    }
+
+    static inline Mask either(const Mask a, const Mask b) {
+        return a | b;
+    }
+
+    static inline Mask without(const Mask a, const Mask b) {
+        return a & ~b;
+    }
+
+    static inline Mask none() {
+        return 0;
+    }
+
+    static inline Mask fromBits(const std::uint32_t bits) {
+        return bits;
+    }
+
+    static inline bool any(const Mask mask) {
+        return mask != 0;
+    }
+
+    /**
+     * @brief Takes a where the mask is set and b elsewhere
+     */
+    static inline Vector select(const Mask mask, const Vector &a, const Vector &b) {
+        return build([mask, &a, &b](const int lane) { return (mask >> lane) & 1 ? a[lane] : b[lane]; });
+    }
+
+    /**
+     * @brief Reads the byte at each lane's offset from a table, keeping the fallback where the mask is clear
+     */
+    static inline Vector gatherBytes(const std::uint8_t *table, const Vector &offsets, const Mask mask, const Vector &fallback) {
+        return build([table, &offsets, mask, &fallback](const int lane) {
+            return (mask >> lane) & 1 ? static_cast<std::int32_t>(table[offsets[lane]]) : fallback[lane];
+        });
+    }
+};
+#endif
+
+/**
+ * @brief What every playout of a batch shares: the shape of the board, its sources and the piece slots
+ */
+struct PlayoutBoard {
+    std::array<std::uint8_t, NUM_SLIDE_VECTORS * MAX_CELLS + GATHER_PADDING> steps{};  // Cell one SLIDE_VECTORS[v] step from cell i at v * MAX_CELLS + i, or NO_STOP
+    std::array<bool, MAX_CELLS> isSource{};    // Whether each cell is a powerup source
+    std::vector<std::uint8_t> sources;         // Cell indices of the powerup sources
+    std::array<int, 2> numSlots{};             // Piece slots of each player, their number of pieces at the start
+    std::array<std::uint8_t, 2> pieceKinds{};   // CellKind of each player's pieces
+    std::array<std::uint8_t, 2> bishopKinds{};  // CellKind of each player's bishops
+    int placementFrequency = 0;                // Turns between powerup placements, 0 if none are placed
+};
+
+/**
+ * @brief PLAYOUT_LANES games stored struct-of-arrays, so one instruction reads the same field of every game
+ * @note Cell i of lane l is at i * PLAYOUT_LANES + l and holds a CellKind, the encoding of Board::field.
+ * Pieces keep their slot for the whole game and a captured piece's slot is set to NO_PIECE
+ */
+struct alignas(64) PlayoutBlock {
+    std::array<std::uint8_t, MAX_CELLS * PLAYOUT_LANES + GATHER_PADDING> cells{};
+    std::array<std::uint8_t, MAX_CELLS * PLAYOUT_LANES> portals{};  // Cell index of the other end of each portal, or NO_PORTAL
+    std::array<std::uint8_t, MAX_CELLS * PLAYOUT_LANES> crumbly{};  // Whether each cell crumbles into a blank when a piece leaves it
+    std::array<std::array<std::uint8_t, MAX_PIECES * PLAYOUT_LANES>, 2> pieces{};  // Cell index of each player's piece in each slot
+    std::array<std::array<std::uint8_t, PLAYOUT_LANES>, 2> numPieces{};
+    std::array<std::array<std::uint8_t, PLAYOUT_LANES>, 2> hops{};  // Hop powerups held by each player
+    std::array<std::uint32_t, PLAYOUT_LANES> random{};             // xorshift32 state of each lane
+    std::array<std::uint8_t, PLAYOUT_LANES> winner{};              // ID of the winner, 0 while the game goes on
+    std::uint32_t active = 0;                                       // Bit of each lane still playing
+};
+
+/**
+ * @brief Gets the number of playout plies played per second
+ */
+double BatchPlayoutResult::pliesPerSecond() const {
+    return seconds > 0.0 ? static_cast<double>(plies) / seconds : 0.0;
+}
+
+/**
+ * @brief Gets the offset of a lane's entry for a cell in a block
+ */
+inline std::size_t laneOffset(const int index, const int lane) {
+    return (static_cast<std::size_t>(index) << LANE_SHIFT) + lane;
+}
+
+/**
+ * @brief Advances a lane's xorshift32 generator
+ * @return The new state, which is also the random number
+ */
+inline std::uint32_t nextRandom(std::uint32_t &state) {
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    return state;
+}
+
+/**
+ * @brief Advances the xorshift32 generator of every lane in the mask
+ */
+inline Lanes::Vector nextRandom(const Lanes::Vector state, const Lanes::Mask mask) {
+    Lanes::Vector next = Lanes::bitXor(state, Lanes::shiftLeft<13>(state));
+    next = Lanes::bitXor(next, Lanes::shiftRight<17>(next));
+    next = Lanes::bitXor(next, Lanes::shiftLeft<5>(next));
+    return Lanes::select(mask, next, state);
+}
+
+/**
+ * @brief Derives the seed of one playout's generator, so a playout's moves do not depend on its lane or block
+ */
+std::uint32_t playoutSeed(const std::uint32_t seed, const int game) {
+    const auto state = static_cast<std::uint32_t>(Random::deriveSeed(seed, static_cast<std::uint64_t>(game)));
+    return state == 0 ? 1 : state;  // xorshift never leaves a zero state
+}
+
+/**
+ * @brief Moves a piece in one lane, with the rules of Game::movePiece
+ * @param board The shared board
+ * @param block The block of games
+ * @param lane The lane of the game
+ * @param side The player moving, 0 or 1
+ * @param slot The slot of the piece
+ * @param target The cell index the piece stops at
+ * @param isHop Whether a hop powerup is used
+ * @note Hops picked up are counted for the player, other powerups are picked up and dropped
+ */
+void applyPlayoutMove(const PlayoutBoard &board, PlayoutBlock &block, const int lane, const int side,
+                      const int slot, const int target, const bool isHop) {
+    std::uint8_t &piece = block.pieces[side][laneOffset(slot, lane)];
+    const std::size_t origin = laneOffset(piece, lane);
+    const std::uint8_t pieceKind = block.cells[origin];
+    if (block.crumbly[origin]) {
+        block.crumbly[origin] = false;
+        block.cells[origin] = static_cast<std::uint8_t>(CellKind::BLANK);
+    } else {
+        block.cells[origin] = static_cast<std::uint8_t>(board.isSource[piece] ? CellKind::POWERUP_SOURCE : CellKind::REGULAR);
+    }
+
+    int landing = target;
+    const std::size_t destination = laneOffset(target, lane);
+    const std::uint8_t targetKind = block.cells[destination];
+    const int opponent = 1 - side;
+    if (targetKind == static_cast<std::uint8_t>(CellKind::HOP)) {
+        block.hops[side][lane]++;
+    } else if (targetKind == static_cast<std::uint8_t>(CellKind::PORTAL)) {
+        // both ends are used up and the piece leaves through the other one
+        landing = block.portals[destination];
+        block.cells[destination] = static_cast<std::uint8_t>(CellKind::REGULAR);
+        block.portals[destination] = NO_PORTAL;
+        block.portals[laneOffset(landing, lane)] = NO_PORTAL;
+    } else if (targetKind == board.pieceKinds[opponent] || targetKind == board.bishopKinds[opponent]) {
+        for (int opponentSlot = 0; opponentSlot < board.numSlots[opponent]; opponentSlot++) {
+            if (std::uint8_t &captured = block.pieces[opponent][laneOffset(opponentSlot, lane)]; captured == target) {
+                captured = NO_PIECE;
+                break;
+            }
+        }
+        if (--block.numPieces[opponent][lane] == 0) {
+            block.winner[lane] = static_cast<std::uint8_t>(side + 1);
+            block.active &= ~(1u << lane);
+        }
+    }
+    block.cells[laneOffset(landing, lane)] = pieceKind;
+    piece = static_cast<std::uint8_t>(landing);
+    if (isHop) {
+        block.hops[side][lane]--;
+    }
+}
+
+/**
+ * @brief Places a random powerup on a random free source in one lane, as Game::placePowerup does
+ */
+void placePlayoutPowerup(const PlayoutBoard &board, PlayoutBlock &block, const int lane) {
+    const auto isFree = [&block, lane](const std::uint8_t source) {
+        return block.cells[laneOffset(source, lane)] == static_cast<std::uint8_t>(CellKind::POWERUP_SOURCE);
+    };
+    const auto numFree = static_cast<std::uint64_t>(std::ranges::count_if(board.sources, isFree));
+    if (numFree == 0) {
+        return;
+    }
+    auto remaining = static_cast<int>((nextRandom(block.random[lane]) * numFree) >> 32);
+    for (const std::uint8_t source : board.sources) {
+        if (isFree(source) && remaining-- == 0) {
+            const auto powerup = static_cast<Powerup>(nextRandom(block.random[lane]) % NUM_POWERUPS);
+            block.cells[laneOffset(source, lane)] = static_cast<std::uint8_t>(powerupToCell(powerup).kind);
+            return;
+        }
+    }
+}
+
+/**
+ * @brief Plays one random ply in every game of a block still going
+ * @param board The shared board
+ * @param block The block of games
+ * @param side The player to move in every game, 0 or 1
+ * @param turnNumber The turn number before the ply
+ * @return The number of games that made a move
+ * @note Every move and hop of every piece is generated for all lanes at once, one slide step per
+ * gather, and each lane keeps one of its legal candidates by reservoir sampling, so the chosen move is
+ * uniform without storing the candidates. A lane's generator only advances on its own candidates, so a
+ * game plays the same moves whatever its lane and whichever instruction set is used. Moves are then
+ * applied lane by lane
+ */
+int playPlayoutPly(const PlayoutBoard &board, PlayoutBlock &block, const int side, const int turnNumber) {
+    using Vector = Lanes::Vector;
+    using Mask = Lanes::Mask;
+    const Vector zero = Lanes::set(0);
+    const Vector one = Lanes::set(1);
+    const Vector blank = Lanes::set(static_cast<int>(CellKind::BLANK));
+    const Vector barrier = Lanes::set(static_cast<int>(CellKind::BARRIER));
+    const Vector ownPiece = Lanes::set(board.pieceKinds[side]);
+    const Vector ownBishop = Lanes::set(board.bishopKinds[side]);
+    const Vector noStop = Lanes::set(NO_STOP);
+    const Vector noPiece = Lanes::set(NO_PIECE);
+    const Vector acceptBound = Lanes::set(1 << RESERVOIR_BITS);
+    const Vector laneIndices = Lanes::load(LANE_INDICES.data());
+
+    const Mask active = Lanes::fromBits(block.active);
+    const Mask hasHop = Lanes::without(active, Lanes::equal(Lanes::loadBytes(block.hops[side].data()), zero));
+    Vector random = Lanes::load(reinterpret_cast<const std::int32_t *>(block.random.data()));
+    Vector count = zero;
+    Vector chosenSlot = zero;
+    Vector chosenTarget = zero;
+    Vector chosenHop = zero;
+    for (int slot = 0; slot < board.numSlots[side]; slot++) {
+        const Vector origin = Lanes::loadBytes(&block.pieces[side][laneOffset(slot, 0)]);
+        const Mask alive = Lanes::without(active, Lanes::equal(origin, noPiece));
+        if (!Lanes::any(alive)) {
+            continue;
+        }
+        const Vector originKind = Lanes::gatherBytes(block.cells.data(), Lanes::add(Lanes::shiftLeft<LANE_SHIFT>(origin), laneIndices), alive, zero);
+        // bishops move along the diagonal vectors, which follow the orthogonal ones in SLIDE_VECTORS
+        const Vector vectorBase = Lanes::select(Lanes::equal(originKind, ownBishop), Lanes::set(4 * MAX_CELLS), zero);
+        for (int hop = 0; hop < 2; hop++) {
+            const Mask moving = hop == 0 ? alive : Lanes::both(alive, hasHop);
+            if (!Lanes::any(moving)) {
+                continue;
+            }
+            for (int direction = 0; direction < 4; direction++) {
+                const Vector stepBase = Lanes::add(vectorBase, Lanes::set((direction + 8 * hop) * MAX_CELLS));
+                Vector position = origin;
+                Mask sliding = moving;
+                Mask legal = Lanes::none();
+                // slide over blank cells until a non-blank cell or the edge of the board
+                while (Lanes::any(sliding)) {
+                    const Vector next = Lanes::gatherBytes(board.steps.data(), Lanes::add(stepBase, position), sliding, noStop);
+                    const Mask onBoard = Lanes::without(sliding, Lanes::equal(next, noStop));
+                    const Vector kind = Lanes::gatherBytes(block.cells.data(), Lanes::add(Lanes::shiftLeft<LANE_SHIFT>(next), laneIndices), onBoard, blank);
+                    position = Lanes::select(onBoard, next, position);
+                    sliding = Lanes::both(onBoard, Lanes::equal(kind, blank));
+                    Mask stopped = Lanes::without(onBoard, sliding);
+                    stopped = Lanes::without(stopped, Lanes::either(Lanes::equal(kind, barrier), Lanes::either(Lanes::equal(kind, ownPiece), Lanes::equal(kind, ownBishop))));
+                    legal = Lanes::either(legal, stopped);
+                }
+                count = Lanes::add(count, Lanes::select(legal, one, zero));
+                random = nextRandom(random, legal);
+                const Mask accept = Lanes::both(legal, Lanes::less(Lanes::multiply(Lanes::shiftRight<32 - RESERVOIR_BITS>(random), count), acceptBound));
+                chosenSlot = Lanes::select(accept, Lanes::set(slot), chosenSlot);
+                chosenTarget = Lanes::select(accept, position, chosenTarget);
+                chosenHop = Lanes::select(accept, Lanes::set(hop), chosenHop);
+            }
+        }
+    }
+
+    alignas(64) std::array<std::int32_t, PLAYOUT_LANES> counts;
+    alignas(64) std::array<std::int32_t, PLAYOUT_LANES> slots;
+    alignas(64) std::array<std::int32_t, PLAYOUT_LANES> targets;
+    alignas(64) std::array<std::int32_t, PLAYOUT_LANES> hops;
+    Lanes::store(counts.data(), count);
+    Lanes::store(slots.data(), chosenSlot);
+    Lanes::store(targets.data(), chosenTarget);
+    Lanes::store(hops.data(), chosenHop);
+    Lanes::store(reinterpret_cast<std::int32_t *>(block.random.data()), random);
+
+    int moved = 0;
+    for (std::uint32_t lanes = block.active; lanes != 0; lanes &= lanes - 1) {
+        const int lane = std::countr_zero(lanes);
+        if (counts[lane] == 0) {
+            // a player without a move or hop loses, as in the MCTS playouts
+            block.winner[lane] = static_cast<std::uint8_t>(2 - side);
+            block.active &= ~(1u << lane);
+            continue;
+        }
+        applyPlayoutMove(board, block, lane, side, slots[lane], targets[lane], hops[lane] != 0);
+        moved++;
+    }
+    if (board.placementFrequency > 0 && (turnNumber + 1) % board.placementFrequency == 0) {
+        for (std::uint32_t lanes = block.active; lanes != 0; lanes &= lanes - 1) {
+            placePlayoutPowerup(board, block, std::countr_zero(lanes));
+        }
+    }
+    return moved;
+}
+
+/**
+ * @brief Copies a game into the shared board and into every lane of a block
+ */
+void loadPlayoutGame(const Game &game, PlayoutBoard &board, PlayoutBlock &block) {
+    const Board &gameBoard = game.board;
+    for (std::size_t v = 0; v < NUM_SLIDE_VECTORS; v++) {
+        for (int index = 0; index < gameBoard.length * gameBoard.width; index++) {
+            const auto [row, column] = gameBoard.toCoord(index);
+            const std::pair<int, int> next = {row + SLIDE_VECTORS[v].first, column + SLIDE_VECTORS[v].second};
+            board.steps[v * MAX_CELLS + index] = gameBoard.isWithinBounds(next) ? static_cast<std::uint8_t>(gameBoard.toIndex(next)) : NO_STOP;
+        }
+    }
+    for (int index = 0; index < gameBoard.length * gameBoard.width; index++) {
+        const CellInfo &info = game.cellInfo[index];
+        board.isSource[index] = info.isPowerupSource;
+        if (info.isPowerupSource) {
+            board.sources.push_back(static_cast<std::uint8_t>(index));
+        }
+        for (int lane = 0; lane < PLAYOUT_LANES; lane++) {
+            block.cells[laneOffset(index, lane)] = static_cast<std::uint8_t>(gameBoard.field.cells[index].kind);
+            block.portals[laneOffset(index, lane)] = info.portalPartner;
+            block.crumbly[laneOffset(index, lane)] = info.isCrumbly;
+        }
+    }
+    board.placementFrequency = game.placesPowerups() ? game.settings.powerupPlacementFrequency : 0;
+    for (int side = 0; side < 2; side++) {
+        const Player &player = side == 0 ? game.player1 : game.player2;
+        board.numSlots[side] = player.numPieces;
+        board.pieceKinds[side] = static_cast<std::uint8_t>(player.cell.kind);
+        board.bishopKinds[side] = static_cast<std::uint8_t>(player.bishopCell.kind);
+        block.pieces[side].fill(NO_PIECE);
+        for (int slot = 0; slot < player.numPieces; slot++) {
+            for (int lane = 0; lane < PLAYOUT_LANES; lane++) {
+                block.pieces[side][laneOffset(slot, lane)] = static_cast<std::uint8_t>(gameBoard.toIndex(player.pieces[slot].coord()));
+            }
+        }
+        block.numPieces[side].fill(static_cast<std::uint8_t>(player.numPieces));
+        block.hops[side].fill(player.inventory[static_cast<std::size_t>(Powerup::HOP)]);
+    }
+}
+
+/**
+ * @brief Gets the number of playouts advanced together, which depends on the instruction set the library was built for
+ */
+int playoutLanes() {
+    return PLAYOUT_LANES;
+}
+
+/**
+ * @brief Plays many uniformly random games out from a position
+ * @param game The position every playout starts from
+ * @param limits The number of playouts, their ply limit and the seed
+ * @return The number of plies played and how the playouts ended
+ * @note Games are played PLAYOUT_LANES at a time in lockstep, stored struct-of-arrays in one block
+ * that stays in the L1 cache. Each ply picks uniformly among the moves and hops of the player to move,
+ * who loses without one. Other powerups are picked up but never used, and powerups are placed on the
+ * game's schedule. Every playout draws from its own generator derived from the seed, so the results
+ * do not depend on the instruction set
+ */
+BatchPlayoutResult runBatchPlayouts(const Game &game, const PlayoutLimits &limits) {
+    const auto startTime = std::chrono::steady_clock::now();
+    PlayoutBoard board;
+    const auto start = std::make_unique<PlayoutBlock>();
+    loadPlayoutGame(game, board, *start);
+    const auto block = std::make_unique<PlayoutBlock>();
+
+    BatchPlayoutResult result;
+    for (int first = 0; first < limits.games; first += PLAYOUT_LANES) {
+        *block = *start;
+        const int lanes = std::min(PLAYOUT_LANES, limits.games - first);
+        block->active = (std::uint32_t{1} << lanes) - 1;
+        for (int lane = 0; lane < lanes; lane++) {
+            block->random[lane] = playoutSeed(limits.seed, first + lane);
+        }
+        int side = game.currentPlayerID - 1;
+        int turnNumber = game.turnNumber;
+        for (int ply = 0; ply < limits.maxPlies && block->active != 0; ply++) {
+            result.plies += playPlayoutPly(board, *block, side, turnNumber);
+            side = 1 - side;
+            turnNumber++;
+        }
+        for (int lane = 0; lane < lanes; lane++) {
+            if (block->winner[lane] != 0) {
+                result.wins[block->winner[lane] - 1]++;
+            }
+        }
+        result.unfinished += std::popcount(block->active);
+        result.games += lanes;
+    }
+    result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+    return result;
+}
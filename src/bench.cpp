@@ -0,0 +1,157 @@
+#include "bench.h"
+
+#include <algorithm>  // std::max
+#include <chrono>
+#include <format>  // std::format
+#include <ostream>
+#include <string_view>
+#include <vector>
+
+#include "batch_playout.h"
+#include "enums.h"
+#include "game.h"
+#include "move_generator.h"
+#include "parallel_search.h"
+#include "random.h"
+#include "scheduler.h"
+#include "search.h"
+#include "transposition_table.h"
+
+// Seed of the random plies leading to the benchmark positions, so every run searches the same positions
+const std::uint32_t BENCH_SEED = 20240611;
+
+// Number of benchmark positions and the random plies played between them
+const int BENCH_POSITIONS = 6;
+const int BENCH_PLIES_BETWEEN = 4;
+
+// Size of the transposition table used by both searches
+const std::size_t BENCH_TABLE_MEGABYTES = 64;
+
+// Share of the batched playouts also played one game object at a time, which is much slower
+const int REFERENCE_PLAYOUT_DIVISOR = 10;
+
+/**
+ * @brief Measures the speedup of the parallel alpha-beta search over the single-threaded search
+ * @param threads The number of workers of the parallel search
+ * @param depth The depth every position is searched to
+ * @param out The stream the timings are reported to
+ * @note Positions are reached by seeded random plies on the Breakout map. The transposition table is
+ * cleared before every search so neither search benefits from the other
+ */
+void benchParallelSearch(const int threads, const int depth, std::ostream &out) {
+    Random::getInstance().seed(BENCH_SEED);
+    SettingsData settings;
+    settings.map = Map::BREAKOUT;
+    Game game(settings);
+    game.history.reserve(MAX_HISTORY);
+
+    TranspositionTable table(BENCH_TABLE_MEGABYTES, false);
+    TaskScheduler scheduler(threads, BENCH_SEED);
+    Searcher serial(table);
+    ParallelSearcher parallel(scheduler, table);
+    ActionList actions;
+    double serialSeconds = 0.0;
+    double parallelSeconds = 0.0;
+    out << std::format("Searching {} Breakout positions to depth {} with 1 and {} threads", BENCH_POSITIONS, depth, threads) << std::endl;
+    for (int position = 0; position < BENCH_POSITIONS; position++) {
+        table.clear();
+        const SearchResult serialResult = serial.search(game, {depth, UINT64_MAX});
+        table.clear();
+        const SearchResult parallelResult = parallel.search(game, {depth, UINT64_MAX});
+        serialSeconds += serialResult.seconds;
+        parallelSeconds += parallelResult.seconds;
+        out << std::format("Position {}: 1 thread {:.3f}s ({:.0f} nodes/s), {} threads {:.3f}s ({:.0f} nodes/s), speedup {:.2f}x",
+                           position + 1, serialResult.seconds, serialResult.nodesPerSecond(), threads,
+                           parallelResult.seconds, parallelResult.nodesPerSecond(), serialResult.seconds / parallelResult.seconds)
+            << std::endl;
+        for (int ply = 0; ply < BENCH_PLIES_BETWEEN; ply++) {
+            generateActions(game, actions);
+            if (actions.empty() || game.getAllyPlayer().numPieces == 0) {
+                break;
+            }
+            game.makeMove(actions[Random::getInstance().getInt(0, static_cast<int>(actions.size) - 1)]);
+        }
+    }
+    out << std::format("Total: 1 thread {:.3f}s, {} threads {:.3f}s, speedup {:.2f}x",
+                       serialSeconds, threads, parallelSeconds, serialSeconds / parallelSeconds)
+        << std::endl;
+}
+
+/**
+ * @brief Plays one uniformly random game out on its own copy of a game, with the policy of runBatchPlayouts
+ * @param game The game to play out, copied
+ * @param maxPlies The plies after which the playout is stopped
+ * @param random The generator to draw moves and placements from
+ * @param actions A list to generate actions into
+ * @param result The result to add the playout to
+ */
+void playReferencePlayout(Game game, const int maxPlies, Random &random, ActionList &actions, BatchPlayoutResult &result) {
+    result.games++;
+    for (int ply = 0; ply < maxPlies; ply++) {
+        const Player &player = game.getAllyPlayer();
+        actions.clear();
+        generatePieceMoves(game.board, player, false, actions);
+        if (player.hasPowerup(Powerup::HOP)) {
+            generatePieceMoves(game.board, player, true, actions);
+        }
+        if (actions.empty()) {
+            result.wins[2 - game.currentPlayerID]++;
+            return;
+        }
+        game.makeMove(actions[random.getInt(0, static_cast<int>(actions.size) - 1)]);
+        result.plies++;
+        if (game.getAllyPlayer().numPieces == 0) {
+            result.wins[2 - game.currentPlayerID]++;
+            return;
+        }
+        if (game.placesPowerups() && game.turnNumber % game.settings.powerupPlacementFrequency == 0) {
+            game.placePowerup(random);
+        }
+    }
+    result.unfinished++;
+}
+
+/**
+ * @brief Writes the speed and outcomes of a set of playouts
+ */
+void reportPlayouts(const std::string_view name, const BatchPlayoutResult &result, std::ostream &out) {
+    const auto percent = [&result](const std::uint64_t count) {
+        return result.games == 0 ? 0.0 : 100.0 * static_cast<double>(count) / static_cast<double>(result.games);
+    };
+    out << std::format("{}: {} games, {} plies in {:.3f}s, {:.2f}M plies/s, player 1 wins {:.1f}%, player 2 wins {:.1f}%, unfinished {:.1f}%",
+                       name, result.games, result.plies, result.seconds, result.pliesPerSecond() / 1e6,
+                       percent(result.wins[0]), percent(result.wins[1]), percent(result.unfinished))
+        << std::endl;
+}
+
+/**
+ * @brief Measures the batched random playouts against playing the same policy one game object at a time
+ * @param map The map the playouts start from
+ * @param games The number of batched playouts, a tenth as many are played one at a time
+ * @param maxPlies The plies after which a playout is stopped
+ * @param out The stream the timings are reported to
+ * @note Both run on one thread from the same start position. Their outcomes should agree to within
+ * sampling error, which checks the batched rules against Game
+ */
+void benchPlayouts(const Map map, const int games, const int maxPlies, std::ostream &out) {
+    Random::getInstance().seed(BENCH_SEED);
+    SettingsData settings;
+    settings.map = map;
+    const Game game(settings);
+    out << std::format("Playing random playouts on {} of at most {} plies, {} games per instruction",
+                       mapToString(map), maxPlies, playoutLanes())
+        << std::endl;
+    const BatchPlayoutResult batched = runBatchPlayouts(game, {games, maxPlies, BENCH_SEED});
+    reportPlayouts("Batched", batched, out);
+
+    Random random(BENCH_SEED);
+    ActionList actions;
+    BatchPlayoutResult reference;
+    const auto startTime = std::chrono::steady_clock::now();
+    for (int i = 0; i < std::max(games / REFERENCE_PLAYOUT_DIVISOR, 1); i++) {
+        playReferencePlayout(game, maxPlies, random, actions, reference);
+    }
+    reference.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+    reportPlayouts("One at a time", reference, out);
+    out << std::format("Speedup {:.1f}x", batched.pliesPerSecond() / reference.pliesPerSecond()) << std::endl;
+}
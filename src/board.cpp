@@ -2,15 +2,17 @@
 
 #include <algorithm>
 #include <functional>
-#include <iostream>
 #include <optional>
-#include <random>
 #include <ranges>
 #include <set>
+#include <span>
+#include <stdexcept>
+#include <string>
 
 #include "enums.h"
 #include "other_tools.h"
 #include "random.h"
+#include "zobrist.h"
 
 // Numbers in the triangle number sequence
 const auto TRIANGLENUMS = std::vector<int>{1, 3, 6, 10, 15, 21, 28, 36, 45, 55, 66, 78, 91, 105};
@@ -22,22 +24,21 @@ const auto LETTERS = std::vector<char>{'A', 'B', 'C', 'D', 'E', 'F', 'G', 'H', '
  * @brief Generates a random coordinate
  * @param length The length of the field
  * @param width The width of the field
+ * @param random The generator to draw from
  * @return A random coordinate
  */
-std::pair<int, int> generateRandomCoord(const int& length, const int& width) {
-    return std::pair<int, int>(Random::getInstance().getInt(0, length - 1),
-                               Random::getInstance().getInt(0, width - 1));
+std::pair<int, int> generateRandomCoord(const int& length, const int& width, Random& random) {
+    const int row = random.getInt(0, length - 1);
+    return std::pair<int, int>(row, random.getInt(0, width - 1));
 }
 
 /**
  * @brief Rotates the field 180 degrees (in-place)
  * @param field The field to rotate
+ * @note In row-major order a 180 degree rotation is a reversal of the whole buffer
  */
-void rotateField(std::vector<std::vector<Cell>>& field) {
-    std::ranges::for_each(field, [](auto& row) {
-        std::ranges::reverse(row);
-    });
-    std::ranges::reverse(field);
+void rotateField(Field& field) {
+    std::ranges::reverse(field.cells);
 }
 
 /**
@@ -46,7 +47,7 @@ void rotateField(std::vector<std::vector<Cell>>& field) {
  * @param dotCell The character to use for the dots
  * @param dotsToPlace The number of dots to place
  */
-void placeDots(std::vector<std::vector<Cell>>& field, const Cell& dotCell, int dotsToPlace) {
+void placeDots(Field& field, const Cell& dotCell, int dotsToPlace) {
     int maxNumDotsInRow = 0;
     for (int i = 0; i < TRIANGLENUMS.size(); i++) {
         if (dotsToPlace <= TRIANGLENUMS[i]) {
@@ -54,9 +55,9 @@ void placeDots(std::vector<std::vector<Cell>>& field, const Cell& dotCell, int d
             break;
         }
     }
-    std::ranges::for_each(field, [&](auto& row) {
+    for (int i = 0; i < field.length; i++) {
         // Pipe operator essentially truncates the row to the first maxNumDotsInRow elements
-        std::ranges::for_each(row | std::views::take(maxNumDotsInRow), [&dotsToPlace, &dotCell](auto& cell) {
+        std::ranges::for_each(field[i] | std::views::take(std::max(maxNumDotsInRow, 0)), [&dotsToPlace, &dotCell](auto& cell) {
             if (dotsToPlace == 0) {
                 return;
             }
@@ -64,7 +65,7 @@ void placeDots(std::vector<std::vector<Cell>>& field, const Cell& dotCell, int d
             dotsToPlace--;
         });
         maxNumDotsInRow--;
-    });
+    }
 }
 
 /**
@@ -73,17 +74,18 @@ void placeDots(std::vector<std::vector<Cell>>& field, const Cell& dotCell, int d
  * @param numToReplace The number of characters to replace
  * @param oldCell The cell to replace
  * @param newCell The cell to replace with
+ * @param random The generator to draw from
  * @note This function is not guaranteed to replace the exact number of
  * characters if no free spaces are available
  */
-void randomReplace(std::vector<std::vector<Cell>>& field,
+void randomReplace(Field& field,
                    int numToReplace, const Cell& oldCell,
-                   const Cell& newCell) {
+                   const Cell& newCell, Random& random) {
     const int MAXITERATIONS = 100;
     int iterations = 0;
 
     while (iterations < MAXITERATIONS && numToReplace > 0) {
-        const auto [x, y] = generateRandomCoord(static_cast<int>(field.size()), static_cast<int>(field[0].size()));
+        const auto [x, y] = generateRandomCoord(field.length, field.width, random);
         // We can initialise col here because it is only needed in the if statement
         if (field[x][y] == oldCell) {
             field[x][y] = newCell;
@@ -100,13 +102,13 @@ void randomReplace(std::vector<std::vector<Cell>>& field,
  * @param barrierShape The shape of the barrier
  * @return True if the barrier can be placed, false otherwise
  */
-bool canPlaceBarrier(std::vector<std::vector<Cell>> const& field, std::pair<int, int> const& baseCoord,
+bool canPlaceBarrier(Field const& field, std::pair<int, int> const& baseCoord,
                      std::set<std::pair<int, int>> const& barrierShape) {
     bool canPlace = true;
     std::ranges::for_each(barrierShape, [&](const auto& coord) {
         const auto [x, y] = vectorAddition(baseCoord, coord);
         // If the coordinates are out of bounds or the cell is not empty, return false
-        if (x < 0 || x >= field.size() || y < 0 || y >= field[0].size() || field[x][y] != REGULAR_CELL) {
+        if (x < 0 || x >= field.length || y < 0 || y >= field.width || field[x][y] != REGULAR_CELL) {
             canPlace = false;
             return;
         }
@@ -121,12 +123,12 @@ bool canPlaceBarrier(std::vector<std::vector<Cell>> const& field, std::pair<int,
  * @param baseCoord The base coordinate to place the barrier
  * @param barrierShape The shape of the barrier
  */
-void placeBarrier(std::vector<std::vector<Cell>>& field,
+void placeBarrier(Field& field,
                   const std::pair<int, int>& baseCoord,
                   const std::set<std::pair<int, int>>& barrierShape) {
     std::ranges::for_each(barrierShape, [&](const auto& coord) {
         const auto barrierCoord = vectorAddition(baseCoord, coord);
-        field[barrierCoord.first][barrierCoord.second] = BARRIER_CELL;
+        field.at(barrierCoord) = BARRIER_CELL;
     });
 }
 
@@ -134,11 +136,12 @@ void placeBarrier(std::vector<std::vector<Cell>>& field,
  * @brief Places barriers on the field
  * @param field The field to place the barriers on
  * @param settings The settings data
+ * @param random The generator to draw from
  * @note This function is not guaranteed to place the exact number of
  * barriers if no free spaces are available
  */
-void placeBarriers(std::vector<std::vector<Cell>>& field,
-                   SettingsData const& settings) {
+void placeBarriers(Field& field,
+                   SettingsData const& settings, Random& random) {
     //   #       #     #     #
     //   # # #   # #   #   # #
     //           #     #
@@ -150,8 +153,8 @@ void placeBarriers(std::vector<std::vector<Cell>>& field,
     const int MAXITERATIONS = 1000;
     int numIterations = 0;
     while (barriersToPlace > 0 && numIterations < MAXITERATIONS) {
-        std::pair<int, int> randCoord = generateRandomCoord(static_cast<int>(field.size()), static_cast<int>(field[0].size()));
-        const auto& randBarrier = *std::next(barrierLayouts.begin(), Random::getInstance().getInt(0, static_cast<int>(barrierLayouts.size()) - 1));
+        std::pair<int, int> randCoord = generateRandomCoord(field.length, field.width, random);
+        const auto& randBarrier = random.getRandomElement(barrierLayouts);
         if (canPlaceBarrier(field, randCoord, randBarrier)) {
             placeBarrier(field, randCoord, randBarrier);
             barriersToPlace--;
@@ -160,38 +163,53 @@ void placeBarriers(std::vector<std::vector<Cell>>& field,
     }
 }
 
+/**
+ * @brief Gets the coordinates of every cell in a plane
+ * @param plane The plane to convert
+ * @return The coordinates of the set bits of the plane
+ */
+std::set<std::pair<int, int>> Board::scanPlane(const Bitboard& plane) const {
+    return visitGeometry([&plane](const auto& geometry) {
+        return ::scanPlane(geometry, plane);
+    });
+}
+
+/**
+ * @brief Scans the field for a cell
+ * @param targetCell The cell to scan for
+ * @return The coordinates of every matching cell
+ */
 std::set<std::pair<int, int>> Board::scanCells(const Cell& targetCell) const {
-    std::set<std::pair<int, int>> coords;
-    for (int i = 0; i < field.size(); i++) {
-        for (int j = 0; j < field[0].size(); j++) {
-            if (field[i][j] == targetCell) {
-                coords.emplace(i, j);
-            }
-        }
-    }
-    return coords;
+    return scanPlane(plane(targetCell));
 }
 
+/**
+ * @brief Scans the field for any of a set of cells
+ * @param targetCells The cells to scan for
+ * @return The coordinates of every matching cell
+ */
 std::set<std::pair<int, int>> Board::scanCells(const std::set<Cell>& targetCells) const {
-    std::set<std::pair<int, int>> coords;
-    for (int i = 0; i < field.size(); i++) {
-        for (int j = 0; j < field[0].size(); j++) {
-            if (targetCells.contains(field[i][j])) {
-                coords.emplace(i, j);
-            }
-        }
+    Bitboard combined;
+    for (const Cell& targetCell : targetCells) {
+        combined |= plane(targetCell);
     }
-    return coords;
+    return scanPlane(combined);
 }
 
-std::vector<std::vector<Cell>> Board::generateRandomMap(SettingsData const& settingsData) const {
-    std::vector<std::vector<Cell>> newField(settingsData.length, std::vector<Cell>(settingsData.width, REGULAR_CELL));
+/**
+ * @brief Generates a random map
+ * @param settingsData The settings data, giving the size of the map and how much of each cell to place
+ * @param random The generator to draw from, so a map can be reproduced from its seed
+ * @return The generated field
+ */
+Field Board::generateRandomMap(SettingsData const& settingsData, Random& random) const {
+    Field newField(settingsData.length, settingsData.width, REGULAR_CELL);
     placeDots(newField, PLAYER_2_CELL, settingsData.numDots);
     rotateField(newField);
     placeDots(newField, PLAYER_1_CELL, settingsData.numDots);
-    randomReplace(newField, settingsData.numInitialPowerups, REGULAR_CELL, POWERUP_SOURCE_CELL);
-    placeBarriers(newField, settingsData);
-    randomReplace(newField, settingsData.numInitialCrumblies, REGULAR_CELL, CRUMBLY_CELL);
+    randomReplace(newField, settingsData.numInitialPowerups, REGULAR_CELL, POWERUP_SOURCE_CELL, random);
+    placeBarriers(newField, settingsData, random);
+    randomReplace(newField, settingsData.numInitialCrumblies, REGULAR_CELL, CRUMBLY_CELL, random);
     return newField;
 }
 
@@ -200,25 +218,38 @@ std::vector<std::vector<Cell>> Board::generateRandomMap(SettingsData const& sett
  * @param settingsData The settings data
  */
 Board::Board(SettingsData const& settingsData)
-    : field(settingsData.map == Map::RANDOM ? generateRandomMap(settingsData) : readMap(settingsData.map)),
-      length(static_cast<int>(field.size())),
-      width(static_cast<int>(field[0].size())) {
+    : field(settingsData.map == Map::RANDOM ? generateRandomMap(settingsData, Random::getInstance()) : readMap(settingsData.map)),
+      length(field.length),
+      width(field.width) {
+    if (length > MAX_BOARD_LENGTH || width > MAX_BOARD_WIDTH) {
+        throw std::invalid_argument("Board dimensions exceed the maximum of " + std::to_string(MAX_BOARD_LENGTH) + "x" + std::to_string(MAX_BOARD_WIDTH));
+    }
+    symmetries.build(length, width);
+    for (int i = 0; i < length * width; i++) {
+        planes[field.cells[i].index()].set(i);
+        toggleHashes(i, field.cells[i]);
+    }
+    visitGeometry([this](const auto& geometry) {
+        slides.build(geometry, plane(BLANK_CELL));
+    });
+    evalTables = buildEvalTables(field, getEvalWeights());
+    accumulator = accumulateField(field, *evalTables);
 }
 /**
  * @brief Places a powerup on the field in a random location
+ * @param random The generator to draw from
  * @note this function may not place the powerup if no free spaces are available,
  * maximum of 100 iterations to attempt placement
  */
-void Board::placePowerup() {
-    std::mt19937 generator(std::random_device{}());
-    std::pair<int, int> coord = generateRandomCoord(length, width);
+void Board::placePowerup(Random& random) {
+    std::pair<int, int> coord = generateRandomCoord(length, width, random);
     int MAXITERS = 100;
     int iters = 0;
-    while (field[coord.first][coord.second] != REGULAR_CELL && iters < MAXITERS) {
-        coord = generateRandomCoord(length, width);
+    while (field.at(coord) != REGULAR_CELL && iters < MAXITERS) {
+        coord = generateRandomCoord(length, width, random);
         iters++;
     }
-    setCell(coord, powerupToCell(generateRandomPowerup()));
+    setCell(coord, powerupToCell(generateRandomPowerup(random)));
 }
 
 /**
@@ -227,7 +258,7 @@ void Board::placePowerup() {
  * @param newCell The character to replace with
  */
 void Board::replaceCell(const std::pair<int, int>& coord, const Cell& newCell) {
-    field[coord.first][coord.second] = newCell;
+    setCell(coord, newCell);
 }
 
 /**
@@ -240,35 +271,79 @@ bool Board::isWithinBounds(const std::pair<int, int>& coord) const {
 }
 
 /**
- * @brief Displays the field to the console
+ * @brief Draws the field as text, one row per line with the column numbers underneath
+ * @return The drawing, for a front end to display
  */
-void Board::show() const {
-    std::cout << "\n";
-    for (int i = 0; i < field.size(); i++) {
-        std::cout << LETTERS[i] << "\t";
-        for (int j = 0; j < field[0].size(); j++) {
-            std::cout << field[i][j].repr() << "\t";
+std::string Board::render() const {
+    std::string text = "\n";
+    // Each row is written into one buffer: a letter, then a representation and a tab per cell
+    std::vector<char> line(2 + static_cast<std::size_t>(width) * (MAX_REPR_LENGTH + 1));
+    for (int i = 0; i < length; i++) {
+        std::size_t lineLength = 0;
+        line[lineLength++] = LETTERS[i];
+        line[lineLength++] = '\t';
+        for (const Cell& cell : field[i]) {
+            lineLength += cell.repr(std::span(line).subspan(lineLength));
+            line[lineLength++] = '\t';
         }
-        std::cout << "\n";
+        text.append(line.data(), lineLength).append("\n");
     }
-    std::cout << "\n";
-    std::cout << "\t";
+    text += "\n\t";
     for (int i = 1; i <= width; i++) {
         if (width > 9 && i < 10) {
-            std::cout << "0";
+            text += "0";
         }
-        std::cout << i << "\t";
+        text += std::to_string(i) + "\t";
     }
-    std::cout << std::endl;
+    return text;
 }
 
 /**
  * @brief Gets the cell at a coordinate
  * @param coord The coordinate to get the character from
- * @return The cell at the coordinate
+ * @return A reference to the cell at the coordinate
  */
-Cell Board::getCell(const std::pair<int, int>& coord) const {
-    return field[coord.first][coord.second];
+const Cell& Board::getCell(const std::pair<int, int>& coord) const {
+    return field.at(coord);
+}
+
+/**
+ * @brief Updates the evaluation accumulator for a cell changing kind
+ * @param coord The coordinate of the cell
+ * @param oldCell The cell being replaced
+ * @param newCell The cell replacing it
+ * @note Only the cell's own terms and its pairs with its eight neighbours change
+ */
+void Board::updateAccumulator(const std::pair<int, int>& coord, const Cell& oldCell, const Cell& newCell) {
+    const EvalTables& tables = *evalTables;
+    accumulator.subtract(tables.squares[oldCell.index()][toIndex(coord)]);
+    accumulator.add(tables.squares[newCell.index()][toIndex(coord)]);
+    const std::uint16_t paired = tables.pairedKinds[oldCell.index()] | tables.pairedKinds[newCell.index()];
+    if (paired == 0) {
+        return;
+    }
+    for (int row = std::max(coord.first - 1, 0); row <= std::min(coord.first + 1, length - 1); row++) {
+        for (int column = std::max(coord.second - 1, 0); column <= std::min(coord.second + 1, width - 1); column++) {
+            const std::size_t neighbour = field.cells[row * width + column].index();
+            if ((paired >> neighbour & 1) == 0 || (row == coord.first && column == coord.second)) {
+                continue;
+            }
+            accumulator.subtract(tables.pairs[oldCell.index()][neighbour]);
+            accumulator.add(tables.pairs[newCell.index()][neighbour]);
+        }
+    }
+}
+
+/**
+ * @brief XORs the keys of a cell into the hash of the field under every symmetry
+ * @param index The index of the cell
+ * @param cell The cell to add or remove
+ */
+void Board::toggleHashes(const int index, const Cell& cell) {
+    for (std::size_t i = 0; i < NUM_SYMMETRIES; i++) {
+        const auto symmetry = static_cast<Symmetry>(i);
+        hashes[i] ^= cellKey(transformCell(cell, symmetry), symmetries.transform(index, symmetry));
+    }
 }
 
 /**
@@ -277,5 +352,32 @@ Cell Board::getCell(const std::pair<int, int>& coord) const {
  * @param newCell The character to set
  */
 void Board::setCell(const std::pair<int, int>& coord, const Cell& newCell) {
-    field[coord.first][coord.second] = newCell;
+    const int index = toIndex(coord);
+    Cell& cell = field.cells[index];
+    planes[cell.index()].reset(index);
+    planes[newCell.index()].set(index);
+    toggleHashes(index, cell);
+    toggleHashes(index, newCell);
+    updateAccumulator(coord, cell, newCell);
+    const bool blankChanged = (cell == BLANK_CELL) != (newCell == BLANK_CELL);
+    cell = newCell;
+    if (blankChanged) {
+        visitGeometry([this, &coord](const auto& geometry) {
+            slides.update(geometry, plane(BLANK_CELL), coord);
+        });
+    }
+}
+
+/**
+ * @brief Gets where a dot stops after moving from a coordinate, sliding over blank cells
+ * @param origin The coordinate the dot moves from
+ * @param vector The direction to move in, one of SLIDE_VECTORS
+ * @return The coordinate the dot stops at or std::nullopt if it slides off the board
+ */
+std::optional<std::pair<int, int>> Board::slide(const std::pair<int, int>& origin, const std::pair<int, int>& vector) const {
+    const std::uint8_t stop = slides.stop(slideVectorIndex(vector), toIndex(origin));
+    if (stop == NO_STOP) {
+        return std::nullopt;
+    }
+    return toCoord(stop);
 }
@@ -1,54 +1,66 @@
 #include "cell.h"
 
-#include <map>
+#include <algorithm>
 #include <stdexcept>
-
-Cell::Cell(const char character, const std::string_view &colour) : character(character), colour(colour) {}
+#include <string>
 
 /**
- * @brief Returns a string representation of the cell in colour
+ * @brief Writes the coloured representation of the cell into a buffer
+ * @param buffer The buffer to write into, must hold at least MAX_REPR_LENGTH characters
+ * @return The number of characters written
  */
-std::string Cell::repr() const {
-    return colour + character + RESET;
+std::size_t Cell::repr(std::span<char> buffer) const {
+    const CellRepr &cellRepr = CELL_REPRS[index()];
+    std::copy_n(cellRepr.characters.begin(), cellRepr.size, buffer.begin());
+    return cellRepr.size;
 }
 
 /**
- * @brief Updates the cell with the character and colour of another cell
+ * @brief Updates the cell with the kind of another cell
  */
 void Cell::update(const Cell &cell) {
-    character = cell.character;
-    colour = cell.colour;
+    kind = cell.kind;
 }
 
 /**
- * @brief Updates the cell with a new character and colour
+ * @brief Updates the cell with a new kind
  */
-void Cell::update(const char &newCharacter, const std::string_view &newColour) {
-    this->character = newCharacter;
-    this->colour = newColour;
+void Cell::update(const CellKind &newKind) {
+    kind = newKind;
 }
+
 /**
  * @brief Converts a character to a cell
  * @param character The character to convert
  * @return The cell
  */
 Cell charToCell(const char &character) {
-    const std::map<char, Cell> cellMap = {
-        {' ', BLANK_CELL},
-        {'/', REGULAR_CELL},
-        {'O', PLAYER_1_CELL},
-        {'X', PLAYER_2_CELL},
-        {'S', POWERUP_SOURCE_CELL},
-        {'#', BARRIER_CELL},
-        {'~', CRUMBLY_CELL},
-        {'@', PORTAL_CELL},
-        {'H', HOP_CELL},
-        {'P', PORTAL_POWER_CELL},
-        {'D', DESTROYER_CELL},
-        {'B', BISHOP_POWER_CELL},
-    };
-    if (!cellMap.contains(character)) {
-        throw std::invalid_argument("Invalid character while converting to cell: " + std::string(1, character));
+    switch (character) {
+        case ' ':
+            return BLANK_CELL;
+        case '/':
+            return REGULAR_CELL;
+        case 'O':
+            return PLAYER_1_CELL;
+        case 'X':
+            return PLAYER_2_CELL;
+        case 'S':
+            return POWERUP_SOURCE_CELL;
+        case '#':
+            return BARRIER_CELL;
+        case '~':
+            return CRUMBLY_CELL;
+        case '@':
+            return PORTAL_CELL;
+        case 'H':
+            return HOP_CELL;
+        case 'P':
+            return PORTAL_POWER_CELL;
+        case 'D':
+            return DESTROYER_CELL;
+        case 'B':
+            return BISHOP_POWER_CELL;
+        default:
+            throw std::invalid_argument("Invalid character while converting to cell: " + std::string(1, character));
     }
-    return cellMap.at(character);
-}
\ No newline at end of file
+}
@@ -0,0 +1,446 @@
+#include "console.h"
+
+#include <algorithm>  // std::minmax
+#include <array>
+#include <cctype>
+#include <format>  // std::format
+#include <iostream>
+#include <ranges>
+#include <set>
+#include <sstream>
+#include <string_view>
+#include <tabulate/table.hpp>
+
+#include "globals.h"
+#include "opening_book.h"
+#include "other_tools.h"
+#include "random.h"
+#include "scheduler.h"
+#include "tablebase.h"
+#include "validation_tools.h"
+
+/**
+ * @brief Displays the field to the console
+ * @param board The board to display
+ */
+void showBoard(const Board &board) {
+    std::cout << board.render() << std::endl;
+}
+
+/**
+ * @brief Displays a 2D vector of strings as a table
+ * @param scores The 2D vector of strings to display
+ * @note Uses the tabulate library to display the table
+ */
+void showScores(const std::vector<std::vector<std::string>> &scores) {
+    tabulate::Table table;
+    table.add_row({"Name", "Length", "Width", "Dots", "Turns"});
+    std::ranges::for_each(scores, [&table](const auto &row) {
+        table.add_row({row.begin(), row.end()});
+    });
+    std::cout << table << std::endl;
+}
+
+/**
+ * @brief Displays a pair of integers as a verbose string in the format "(0, 0) : A1"
+ * @param coord The pair of integers to display
+ * @note Uses the verboseCoord function to convert the pair to a string
+ */
+void showCoord(const std::pair<int, int> &coord) {
+    std::cout << verboseCoord(coord) << std::endl;
+}
+
+/**
+ * @brief Displays a map of characters to pairs of integers as a list of moves
+ * @param moves The map of characters to pairs of integers to display
+ * @note Uses the verboseCoord function to convert the pairs to strings
+ */
+void showMoves(const std::map<char, std::pair<int, int>, std::less<>> &moves) {
+    std::cout << "Possible moves:\n";
+    for (const auto &[key, value] : moves) {
+        std::cout << key << " : " << verboseCoord(value) << "\n";
+    }
+}
+
+/**
+ * @brief Prints the settings to the console in a tabulated format
+ * @param settings The settings to print
+ * @note Uses the tabulate library
+ */
+void showSettings(const SettingsData &settings) {
+    tabulate::Table table;
+    table.add_row({"Number", "Name", "Value"});
+    table.add_row({"1", "Map", mapToString(settings.map)});
+    table.add_row({"2", "Length", std::to_string(settings.length)});
+    table.add_row({"3", "Width", std::to_string(settings.width)});
+    table.add_row({"4", "Number of Dots", std::to_string(settings.numDots)});
+    table.add_row({"5", "Number of Initial Powerups", std::to_string(settings.numInitialPowerups)});
+    table.add_row({"6", "Powerup Placement Frequency", settings.powerupPlacementFrequency > 0 ? std::to_string(settings.powerupPlacementFrequency) : "Off"});
+    table.add_row({"7", "Number of Initial Crumblies", std::to_string(settings.numInitialCrumblies)});
+    table.add_row({"8", "Barrier Density", std::to_string(settings.barrierDensity)});
+    table.add_row({"9", "Number of Deletes", std::to_string(settings.numDeletes)});
+    table.add_row({"10", "Number of Creates", std::to_string(settings.numCreates)});
+    table.add_row({"11", "Player 1", playerTypeToString(settings.player1Type)});
+    table.add_row({"12", "Player 2", playerTypeToString(settings.player2Type)});
+    table.add_row({"13", "Computer Search Depth", std::to_string(settings.searchDepth)});
+    table.add_row({"14", "Computer Node Budget", std::to_string(settings.searchNodes)});
+    table.add_row({"15", "Transposition Table Size (MB)", std::to_string(settings.tableMegabytes)});
+    table.add_row({"16", "Use Huge Pages", settings.useHugePages ? "Yes" : "No"});
+    table.add_row({"17", "Search Threads", std::to_string(settings.searchThreads)});
+    table.add_row({"18", "Monte Carlo Think Time (ms)", std::to_string(settings.thinkMilliseconds)});
+    std::cout << table << std::endl;
+}
+
+/**
+ * @brief Reports the tablebase and opening book files that could not be opened
+ */
+void showSkippedFiles() {
+    for (const std::string &message : getTablebases().getSkipped()) {
+        std::cerr << message << std::endl;
+    }
+    for (const std::string &message : getOpeningBooks().getSkipped()) {
+        std::cerr << message << std::endl;
+    }
+}
+
+/**
+ * @brief Prompts the user to choose a map using an integer menu
+ * @returns The map type
+ */
+Map getValidMap() {
+    std::string prompt = "Choose a map:";
+    for (int i = 0; i < static_cast<int>(Map::COUNT); i++) {
+        prompt += std::format("\n{}) {}", i + 1, mapToString(static_cast<Map>(i)));
+    }
+    return static_cast<Map>(getValidInt(prompt, 1, static_cast<int>(Map::COUNT)) - 1);
+}
+
+/**
+ * @brief Prompts the user to choose who controls a player using an integer menu
+ * @param playerID The ID of the player being chosen for
+ * @returns The player type
+ */
+PlayerType getValidPlayerType(const int playerID) {
+    std::string prompt = std::format("Who controls player {}?", playerID);
+    for (int i = 0; i < static_cast<int>(PlayerType::COUNT); i++) {
+        prompt += std::format("\n{}) {}", i + 1, playerTypeToString(static_cast<PlayerType>(i)));
+    }
+    return static_cast<PlayerType>(getValidInt(prompt, 1, static_cast<int>(PlayerType::COUNT)) - 1);
+}
+
+/**
+ * @brief Prompts the user to edit the settings and updates any changes
+ * @param settings The settings to edit
+ */
+void editSettings(SettingsData &settings) {
+    std::map<int, std::function<void()>> actions = {
+        {1, [&settings]() { settings.map = getValidMap(); }},
+        {2, [&settings]() { settings.length = getValidInt("Enter the new length", MIN_BOARD_LENGTH, MAX_BOARD_LENGTH); }},
+        {3, [&settings]() { settings.width = getValidInt("Enter the new width", MIN_BOARD_WIDTH, MAX_BOARD_WIDTH); }},
+        {4, [&settings]() { settings.numDots = getValidInt("Enter the new number of dots", 3, 10); }},
+        {5, [&settings]() { settings.numInitialPowerups = getValidInt("Enter the new number of initial powerups", 5, 10); }},
+        {6, [&settings]() { settings.powerupPlacementFrequency = getValidInt("Enter the new powerup placement frequency (0 to turn placement off)", 0, 10); }},
+        {7, [&settings]() { settings.numInitialCrumblies = getValidInt("Enter the new number of initial crumblies", 3, 10); }},
+        {8, [&settings]() { settings.barrierDensity = getValidInt("Enter the new barrier density", 4, 10); }},
+        {9, [&settings]() { settings.numDeletes = getValidInt("Enter the new number of deletes", 3, 10); }},
+        {10, [&settings]() { settings.numCreates = getValidInt("Enter the new number of creates", 3, 10); }},
+        {11, [&settings]() { settings.player1Type = getValidPlayerType(1); }},
+        {12, [&settings]() { settings.player2Type = getValidPlayerType(2); }},
+        {13, [&settings]() { settings.searchDepth = getValidInt("Enter the new computer search depth", 1, MAX_SEARCH_DEPTH); }},
+        {14, [&settings]() { settings.searchNodes = getValidInt("Enter the new computer node budget per move", MIN_SEARCH_NODES, MAX_SEARCH_NODES); }},
+        {15, [&settings]() { settings.tableMegabytes = getValidInt("Enter the new transposition table size in MB", MIN_TABLE_MEGABYTES, MAX_TABLE_MEGABYTES); }},
+        {16, [&settings]() { settings.useHugePages = confirm("Back the transposition table with huge pages?"); }},
+        {17, [&settings]() { settings.searchThreads = getValidInt("Enter the new number of search threads", 1, MAX_SEARCH_THREADS); }},
+        {18, [&settings]() { settings.thinkMilliseconds = getValidInt("Enter the new Monte Carlo think time per move in ms", MIN_THINK_MILLISECONDS, MAX_THINK_MILLISECONDS); }}};
+
+    while (true) {
+        showSettings(settings);
+        const int option = getValidInt("What would you like to edit? (19 to exit)", 1, 19);
+        if (option == 19) {
+            break;
+        }
+        auto it = actions.find(option);
+        it->second();
+    }
+}
+
+/**
+ * @brief Prompts the player to select a powerup from their inventory and returns the selected powerup
+ * @param player The player choosing
+ * @return The selected powerup or std::nullopt if the user cancels
+ * @note If the player has no powerups, a message is displayed and std::nullopt is returned
+ */
+std::optional<Powerup> selectPowerup(const Player &player) {
+    if (!player.hasPowerups()) {
+        std::cout << "You have no powerups!" << std::endl;
+        return std::nullopt;
+    }
+    std::ostringstream prompt;
+    prompt << "Which powerup would you like to use?";
+    std::vector<Powerup> options;
+    for (std::size_t i = 0; i < NUM_POWERUPS; ++i) {
+        if (player.inventory[i] > 0) {
+            options.push_back(static_cast<Powerup>(i));
+            prompt << std::format("\n{}) {} (x{})", options.size(), powerupToString(options.back()), player.inventory[i]);
+        }
+    }
+    const auto exitNum = static_cast<int>(options.size()) + 1;
+    prompt << "\n"
+           << exitNum << ") Cancel";
+    const int choice = getValidInt(prompt.str(), 1, exitNum);
+    if (choice == exitNum) {
+        return std::nullopt;
+    }
+    return options.at(choice - 1);
+}
+
+/**
+ * @brief Prompts the player to select a dot to move and returns the dot
+ * @param player The player choosing
+ * @return The selected dot or std::nullopt if the user cancels
+ */
+std::optional<Piece> selectPiece(const Player &player) {
+    std::ostringstream prompt;
+    prompt << "Which piece would you like to move?";
+    int count = 1;
+    for (const auto &piece : player.getPieces()) {
+        prompt << std::format("\n{}) {}", count++, coordToString(piece.coord()));
+    }
+    const int exitNum = count;
+    prompt << std::format("\n{}) Cancel", exitNum);
+    const int selected = getValidInt(prompt.str(), 1, exitNum);
+    if (selected == exitNum) {
+        return std::nullopt;
+    }
+    return std::make_optional(player.getPieces()[selected - 1]);
+}
+
+/**
+ * @brief Prompts the user to select a destination for the dot and returns the destination
+ * @param moves The possible moves for the dot
+ * @return The selected destination or std::nullopt if the user cancels
+ */
+std::optional<std::pair<int, int>> selectDestination(const std::map<DirectionData, std::pair<int, int>> &moves) {
+    std::ostringstream prompt;
+    prompt << "Where would you like to move the dot?";
+    std::set<char> accepted = {'C', 'c'};
+    for (const auto &[move, _] : moves) {
+        prompt << std::format("\n{}) {}", move.key, move.name);
+        accepted.insert(move.key);
+        accepted.emplace(static_cast<char>(std::tolower(move.key)));
+    }
+    prompt << "\nC) Cancel";
+    // convert input to upper case character
+    const auto wasd = static_cast<char>(std::toupper(getValidString(prompt.str(), 1, 1, "C", std::make_optional(accepted)).value()[0]));
+    if (wasd == 'C') {
+        return std::nullopt;
+    }
+    return std::ranges::find_if(moves, [&wasd](const auto &move) { return move.first.key == wasd; })->second;
+}
+
+/**
+ * @brief Prompts the user for a coordinate holding a specific cell
+ * @param board The game board
+ * @param prompt The prompt to display to the user
+ * @param targetCell The cell the coordinate must hold
+ * @return The coordinate or std::nullopt if the user cancels
+ */
+std::optional<std::pair<int, int>> selectCoord(const Board &board, const std::string &prompt, const Cell &targetCell) {
+    while (true) {
+        const auto coord = getValidCoord(prompt, board.length, board.length);
+        if (coord == std::nullopt) {
+            return std::nullopt;
+        }
+        if (board.getCell(coord.value()) == targetCell) {
+            return coord;
+        }
+        std::array<char, MAX_REPR_LENGTH> repr{};
+        const std::size_t reprLength = targetCell.repr(repr);
+        std::cout << "Coordinate does not correspond to " << std::string_view(repr.data(), reprLength) << std::endl;
+    }
+}
+
+/**
+ * @brief Prompts the user for a move, or a hop, of one of their dots
+ * @param board The game board
+ * @param player The player moving
+ * @param isHop Whether a hop powerup is used
+ * @return The move or hop action, or std::nullopt if the user cancels
+ */
+std::optional<Action> attemptMove(const Board &board, const Player &player, const bool isHop) {
+    std::map<DirectionData, std::pair<int, int>> moves;
+    std::optional<Piece> selectedPiece;
+    while (true) {
+        selectedPiece = selectPiece(player);
+        if (!selectedPiece.has_value()) {  // check if user cancelled piece selection
+            return std::nullopt;
+        }
+        moves = player.detectMoves(board, selectedPiece.value(), isHop);
+        if (moves.empty()) {
+            std::cout << "This dot cannot move." << std::endl;
+            continue;
+        }
+        break;
+    }
+    const std::optional<std::pair<int, int>> destination = selectDestination(moves);
+    if (!destination.has_value()) {  // check if user cancelled destination selection
+        return std::nullopt;
+    }
+    return Action{isHop ? ActionType::HOP : ActionType::MOVE,
+                  static_cast<std::uint8_t>(board.toIndex(selectedPiece.value().coord())),
+                  static_cast<std::uint8_t>(board.toIndex(destination.value()))};
+}
+
+/**
+ * @brief Prompts the current player to choose a powerup and how to use it
+ * @param game The game being played
+ * @return The powerup action, or std::nullopt if the user cancels or the powerup cannot be used that way
+ */
+std::optional<Action> selectPowerupAction(const Game &game) {
+    const Player &player = game.getAllyPlayer();
+    const Board &board = game.board;
+    const std::optional<Powerup> chosenPowerup = selectPowerup(player);
+    if (!chosenPowerup.has_value()) {
+        return std::nullopt;
+    }
+    switch (chosenPowerup.value()) {
+        case Powerup::PORTAL: {
+            const std::optional<std::pair<int, int>> coord_1 = selectCoord(board, "Enter the first portal coordinate", REGULAR_CELL);
+            if (!coord_1.has_value()) {
+                return std::nullopt;
+            }
+            std::optional<std::pair<int, int>> coord_2;
+            while (true) {
+                coord_2 = selectCoord(board, "Enter the second portal coordinate", REGULAR_CELL);
+                if (!coord_2.has_value()) {
+                    return std::nullopt;
+                }
+                if (coord_2 != coord_1) {
+                    break;
+                }
+                std::cout << "The ends of a portal must be different cells" << std::endl;
+            }
+            // generateActions lists portal ends in ascending order
+            const auto [first, second] = std::minmax(board.toIndex(coord_1.value()), board.toIndex(coord_2.value()));
+            return Action{ActionType::PORTAL, static_cast<std::uint8_t>(first), static_cast<std::uint8_t>(second)};
+        }
+        case Powerup::HOP:
+            return attemptMove(board, player, true);
+        case Powerup::DESTROYER: {
+            const std::optional<std::pair<int, int>> coord = selectCoord(board, "Which barrier would you like to destroy?", BARRIER_CELL);
+            if (!coord.has_value()) {
+                return std::nullopt;
+            }
+            return Action{ActionType::DESTROYER, static_cast<std::uint8_t>(board.toIndex(coord.value())), 0};
+        }
+        case Powerup::BISHOP: {
+            const std::optional<Piece> chosenPiece = selectPiece(player);
+            if (!chosenPiece.has_value()) {
+                return std::nullopt;
+            }
+            if (chosenPiece.value().isBishop) {
+                std::cout << "This piece is already a bishop!" << std::endl;
+                return std::nullopt;
+            }
+            return Action{ActionType::BISHOP, static_cast<std::uint8_t>(board.toIndex(chosenPiece.value().coord())), 0};
+        }
+        default:
+            return std::nullopt;
+    }
+}
+
+/**
+ * @brief Applies the current player's action and announces any powerup they pick up
+ * @param game The game being played
+ * @param action The action to apply, which must be legal
+ * @note The turn is not passed, so the front end can check for a win first
+ */
+void applyTurnAction(Game &game, const Action &action) {
+    UndoRecord record{};
+    game.applyAction(action, record);
+    if (record.pickup != Powerup::COUNT) {
+        std::cout << std::format("Player {} has found a {}!", game.currentPlayerID, powerupToString(record.pickup)) << std::endl;
+    }
+}
+
+/**
+ * @brief Plays the current computer player's action and reports how it was chosen
+ * @param game The game being played
+ * @param table The transposition table to search with
+ * @param scheduler The scheduler the alpha-beta search splits its work over
+ * @param mctsSearcher The Monte Carlo tree searcher, kept for the whole game
+ * @return True if an action was played, false if the player has no legal actions
+ */
+bool playComputerTurn(Game &game, TranspositionTable &table, TaskScheduler &scheduler, MctsSearcher &mctsSearcher) {
+    const std::optional<ComputerChoice> choice = game.chooseComputerAction(table, scheduler, mctsSearcher);
+    if (!choice.has_value()) {
+        return false;
+    }
+    std::cout << std::format("Player {} plays: {}", game.currentPlayerID, game.describeAction(choice->action)) << std::endl;
+    std::cout << std::format("({})", choice->reason) << std::endl;
+    applyTurnAction(game, choice->action);
+    return true;
+}
+
+/**
+ * @brief Prompts the user to save their score and saves it in the scores file
+ * @param game The finished game
+ */
+void scoreSave(const Game &game) {
+    if (confirm("Would you like to save the score?")) {
+        std::vector<std::vector<std::string>> scores = import2D(SCORESPATH);
+        std::string scoreName = getValidString("Enter your names (c to cancel): ", 1, 20, "c", std::nullopt, std::set<char>{',', '\n'}).value();
+        scores.push_back({scoreName, std::to_string(game.board.length), std::to_string(game.board.width), std::to_string(game.settings.numDots), std::to_string(game.turnNumber)});
+        export2D(SCORESPATH, scores);
+    }
+}
+
+/**
+ * @brief Main game loop - plays the game until a player wins or concedes
+ * @param game The game to play, from its first turn
+ * @param table The transposition table used by computer players, cleared before the game starts
+ */
+void playGame(Game &game, TranspositionTable &table) {
+    table.clear();
+    TaskScheduler scheduler(game.settings.searchThreads, static_cast<std::uint32_t>(Random::freshSeed()));
+    // Kept for the whole game, so the tree's arenas are allocated once rather than every computer turn
+    MctsSearcher mctsSearcher;
+    while (true) {
+        if (game.placesPowerups() && game.turnNumber % game.settings.powerupPlacementFrequency == 0) {
+            game.placePowerup();
+        }
+        showBoard(game.board);
+        std::cout << std::format("Player {}'s turn  \t\tTurn: {}", game.currentPlayerID, game.turnNumber) << std::endl;
+        if (game.getPlayerType() != PlayerType::HUMAN) {
+            if (!playComputerTurn(game, table, scheduler, mctsSearcher)) {
+                std::cout << "Player " << game.currentPlayerID << " has no moves left and concedes." << std::endl;
+                game.currentPlayerID = 3 - game.currentPlayerID;
+                break;
+            }
+        } else {
+            const int option = getValidInt("What would you like to do? \n1) Move\n2) Use a Powerup\n3) Concede", 1, 3);
+            std::optional<Action> action;
+            if (option == 1) {
+                action = attemptMove(game.board, game.getAllyPlayer(), false);
+            } else if (option == 2) {
+                action = selectPowerupAction(game);
+            } else if (confirm("Are you sure you want to concede?")) {
+                std::cout << "Player " << game.currentPlayerID << " has conceded." << std::endl;
+                game.currentPlayerID = 3 - game.currentPlayerID;  // the other player wins
+                break;
+            }
+            if (!action.has_value()) {
+                continue;
+            }
+            applyTurnAction(game, action.value());
+        }
+        if (game.checkDefeat()) {
+            showBoard(game.board);
+            break;
+        }
+        game.currentPlayerID = 3 - game.currentPlayerID;
+        game.turnNumber += 1;
+    }
+    std::cout << std::format("Player {} has won in {} turns!", game.currentPlayerID, game.turnNumber) << std::endl;
+    scoreSave(game);
+}
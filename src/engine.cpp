@@ -0,0 +1,459 @@
+#include "engine.h"
+
+#include <algorithm>  // std::find
+#include <array>
+#include <charconv>  // std::from_chars
+#include <cstdint>
+#include <format>  // std::format
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "game.h"
+#include "mcts.h"
+#include "move_generator.h"
+#include "notation.h"
+#include "opening_book.h"
+#include "parallel_search.h"
+#include "random.h"
+#include "scheduler.h"
+#include "search.h"
+#include "settings_data.h"
+#include "transposition_table.h"
+
+/**
+ * @brief A whole number setting of the engine, changed with "setoption name <name> value <value>"
+ */
+struct SpinOption {
+    std::string_view name;
+    int SettingsData::*member;
+    int min;
+    int max;
+};
+
+// The whole number settings, in the order "dotto" lists them
+const std::array<SpinOption, 14> SPIN_OPTIONS = {{
+    {"Length", &SettingsData::length, MIN_BOARD_LENGTH, MAX_BOARD_LENGTH},
+    {"Width", &SettingsData::width, MIN_BOARD_WIDTH, MAX_BOARD_WIDTH},
+    {"Dots", &SettingsData::numDots, 1, 10},
+    {"Powerups", &SettingsData::numInitialPowerups, 0, 10},
+    {"PowerupFrequency", &SettingsData::powerupPlacementFrequency, 0, 10},
+    {"Crumblies", &SettingsData::numInitialCrumblies, 0, 10},
+    {"BarrierDensity", &SettingsData::barrierDensity, 0, 10},
+    {"Deletes", &SettingsData::numDeletes, 0, 10},
+    {"Creates", &SettingsData::numCreates, 0, 10},
+    {"Depth", &SettingsData::searchDepth, 1, MAX_SEARCH_DEPTH},
+    {"Nodes", &SettingsData::searchNodes, MIN_SEARCH_NODES, MAX_SEARCH_NODES},
+    {"Hash", &SettingsData::tableMegabytes, MIN_TABLE_MEGABYTES, MAX_TABLE_MEGABYTES},
+    {"Threads", &SettingsData::searchThreads, 1, MAX_SEARCH_THREADS},
+    {"ThinkTime", &SettingsData::thinkMilliseconds, MIN_THINK_MILLISECONDS, MAX_THINK_MILLISECONDS},
+}};
+
+/**
+ * @brief Splits a line into words separated by spaces, tabs or a carriage return
+ * @param line The line to split
+ * @param words The list the words are written to, reused between lines
+ */
+void splitWords(std::string_view line, std::vector<std::string_view> &words) {
+    words.clear();
+    std::size_t start = 0;
+    while (start < line.size()) {
+        if (line[start] == ' ' || line[start] == '\t' || line[start] == '\r') {
+            start++;
+            continue;
+        }
+        std::size_t end = start;
+        while (end < line.size() && line[end] != ' ' && line[end] != '\t' && line[end] != '\r') {
+            end++;
+        }
+        words.push_back(line.substr(start, end - start));
+        start = end;
+    }
+}
+
+/**
+ * @brief Reads a whole number from a word
+ * @tparam T The type of the number
+ * @param word The word to read
+ * @return The number, or std::nullopt if the whole word is not a number of the type
+ */
+template <typename T>
+std::optional<T> parseNumber(const std::string_view word) {
+    T value{};
+    const auto [end, error] = std::from_chars(word.data(), word.data() + word.size(), value);
+    if (error != std::errc() || end != word.data() + word.size()) {
+        return std::nullopt;
+    }
+    return value;
+}
+
+/**
+ * @brief The state of an engine session: its settings, tables and the position being analysed
+ * @note Each command answers with complete lines and flushes only after the last, so a controller
+ * can pipeline commands. Commands that set up the position answer only on an error
+ */
+class Engine {
+   public:
+    explicit Engine(std::ostream &output);
+
+    bool handle(const std::vector<std::string_view> &words);
+
+   private:
+    std::ostream &output;
+    SettingsData settings;
+    bool useMcts = false;  // Whether "go" runs the Monte Carlo tree search instead of alpha-beta
+    bool useBook = true;   // Whether "go" plays opening book actions
+    TranspositionTable table;
+    std::unique_ptr<TaskScheduler> scheduler;
+    std::unique_ptr<Searcher> searcher;
+    MctsSearcher mctsSearcher;
+    std::unique_ptr<Game> start;  // The position "position startpos" returns to
+    std::unique_ptr<Game> game;
+    std::unique_ptr<ActionList> actions;
+
+    void identify();
+    void setOption(const std::vector<std::string_view> &words);
+    void setPosition(const std::vector<std::string_view> &words);
+    void playWords(const std::vector<std::string_view> &words, std::size_t first);
+    void listLegal();
+    void go(const std::vector<std::string_view> &words);
+    void place();
+    void display();
+    void error(const std::string_view message);
+    bool isOver() const;
+};
+
+/**
+ * @brief Construct a new Engine object, set up on a generated map with the default settings
+ * @param output The stream responses are written to
+ */
+Engine::Engine(std::ostream &output) : output(output),
+                                       table(settings.tableMegabytes, settings.useHugePages),
+                                       scheduler(std::make_unique<TaskScheduler>(settings.searchThreads, static_cast<std::uint32_t>(Random::freshSeed()))),
+                                       searcher(std::make_unique<Searcher>(table)),
+                                       start(std::make_unique<Game>(settings)),
+                                       game(std::make_unique<Game>(*start)),
+                                       actions(std::make_unique<ActionList>()) {}
+
+/**
+ * @brief Runs one command
+ * @param words The words of the command line, not empty
+ * @return False once the session should end
+ */
+bool Engine::handle(const std::vector<std::string_view> &words) {
+    const std::string_view command = words[0];
+    if (command == "dotto") {
+        identify();
+    } else if (command == "isready") {
+        output << "readyok" << std::endl;
+    } else if (command == "setoption") {
+        setOption(words);
+    } else if (command == "newgame") {
+        table.clear();
+    } else if (command == "position") {
+        setPosition(words);
+    } else if (command == "moves") {
+        playWords(words, 1);
+    } else if (command == "legal") {
+        listLegal();
+    } else if (command == "go") {
+        go(words);
+    } else if (command == "place") {
+        place();
+    } else if (command == "d") {
+        display();
+    } else if (command == "quit") {
+        return false;
+    } else {
+        error(std::format("unknown command {}", command));
+    }
+    return true;
+}
+
+/**
+ * @brief Answers "dotto" with the engine's name and options, ending with "dottook"
+ */
+void Engine::identify() {
+    output << "id name dotto-cpp\n";
+    const SettingsData defaults;
+    for (const SpinOption &option : SPIN_OPTIONS) {
+        output << std::format("option name {} type spin default {} min {} max {}\n", option.name, defaults.*option.member, option.min, option.max);
+    }
+    output << "option name Searcher type combo default AlphaBeta var AlphaBeta var MCTS\n";
+    output << "option name OwnBook type check default true\n";
+    output << "dottook" << std::endl;
+}
+
+/**
+ * @brief Runs "setoption name <name> value <value>"
+ * @note Board settings take effect from the next "position" on a map, search settings straight away
+ */
+void Engine::setOption(const std::vector<std::string_view> &words) {
+    if (words.size() != 5 || words[1] != "name" || words[3] != "value") {
+        error("expected setoption name <name> value <value>");
+        return;
+    }
+    const std::string_view name = words[2];
+    const std::string_view value = words[4];
+    if (name == "Searcher") {
+        if (value != "AlphaBeta" && value != "MCTS") {
+            error(std::format("invalid value {} for Searcher", value));
+            return;
+        }
+        useMcts = value == "MCTS";
+        return;
+    }
+    if (name == "OwnBook") {
+        if (value != "true" && value != "false") {
+            error(std::format("invalid value {} for OwnBook", value));
+            return;
+        }
+        useBook = value == "true";
+        return;
+    }
+    for (const SpinOption &option : SPIN_OPTIONS) {
+        if (option.name != name) {
+            continue;
+        }
+        const std::optional<int> number = parseNumber<int>(value);
+        if (!number.has_value() || number.value() < option.min || number.value() > option.max) {
+            error(std::format("invalid value {} for {}", value, name));
+            return;
+        }
+        settings.*option.member = number.value();
+        if (name == "Hash") {
+            table.resize(settings.tableMegabytes, settings.useHugePages);
+        } else if (name == "Threads") {
+            scheduler = std::make_unique<TaskScheduler>(settings.searchThreads, static_cast<std::uint32_t>(Random::freshSeed()));
+        }
+        return;
+    }
+    error(std::format("unknown option {}", name));
+}
+
+/**
+ * @brief Runs "position <map> [seed <seed>] [moves <word>...]" or "position startpos [moves <word>...]"
+ * @note A map name starts a new game on that map with the current settings. Generated maps are
+ * drawn from the calling thread's generator, seeded first if a seed is given so a controller can
+ * reproduce them. startpos returns to the start of the last game set up
+ */
+void Engine::setPosition(const std::vector<std::string_view> &words) {
+    std::size_t next = 2;
+    if (words.size() < 2) {
+        error("expected position <map> [seed <seed>] [moves <word>...]");
+        return;
+    }
+    if (words[1] != "startpos") {
+        SettingsData gameSettings = settings;
+        try {
+            gameSettings.map = stringToMap(std::string(words[1]));
+        } catch (const std::invalid_argument &e) {
+            error(e.what());
+            return;
+        }
+        if (next < words.size() && words[next] == "seed") {
+            const std::optional<std::uint32_t> seed = next + 1 < words.size() ? parseNumber<std::uint32_t>(words[next + 1]) : std::nullopt;
+            if (!seed.has_value()) {
+                error("expected a whole number seed");
+                return;
+            }
+            Random::getInstance().seed(seed.value());
+            next += 2;
+        }
+        // A fixed map starts the same way every time, so it is only read again if the settings change
+        if (gameSettings.map == Map::RANDOM || start->settings != gameSettings) {
+            try {
+                start = std::make_unique<Game>(gameSettings);
+            } catch (const std::exception &e) {
+                error(e.what());
+                return;
+            }
+        }
+    }
+    game = std::make_unique<Game>(*start);
+    if (next < words.size()) {
+        if (words[next] != "moves") {
+            error(std::format("unexpected word {}", words[next]));
+            return;
+        }
+        playWords(words, next + 1);
+    }
+}
+
+/**
+ * @brief Plays actions and powerup placements, written in the protocol notation, on the position
+ * @param words The words of the command
+ * @param first The index of the first word to play
+ * @note Stops at the first word that is not a legal action or placement, keeping those before it
+ */
+void Engine::playWords(const std::vector<std::string_view> &words, const std::size_t first) {
+    for (std::size_t i = first; i < words.size(); i++) {
+        if (words[i].front() == '+') {
+            const std::optional<Placement> placement = stringToPlacement(game->board, words[i]);
+            if (!placement.has_value() || game->board.getCell(placement->coord) != POWERUP_SOURCE_CELL) {
+                error(std::format("illegal placement {}", words[i]));
+                return;
+            }
+            game->placePowerup(placement->coord, placement->powerup);
+            continue;
+        }
+        const std::optional<Action> action = stringToAction(game->board, words[i]);
+        if (!action.has_value() || isOver()) {
+            error(std::format("illegal action {}", words[i]));
+            return;
+        }
+        generateActions(*game, *actions);
+        if (std::find(actions->begin(), actions->end(), action.value()) == actions->end()) {
+            error(std::format("illegal action {}", words[i]));
+            return;
+        }
+        game->makeMove(action.value());
+    }
+}
+
+/**
+ * @brief Answers "legal" with one line listing every legal action of the player to move
+ */
+void Engine::listLegal() {
+    std::string line = "legal";
+    if (!isOver()) {
+        generateActions(*game, *actions);
+        for (const Action &action : *actions) {
+            line += ' ';
+            line += actionToString(game->board, action);
+        }
+    }
+    output << line << std::endl;
+}
+
+/**
+ * @brief Runs "go [depth <plies>] [nodes <nodes>] [movetime <milliseconds>]" and answers with an info
+ * line and "bestmove <action>", or "bestmove none" if the game is over
+ * @note Without limits the search uses the Depth and Nodes options, or ThinkTime for the Monte
+ * Carlo searcher. Limits that are given replace all of those, and the rest are unlimited
+ */
+void Engine::go(const std::vector<std::string_view> &words) {
+    std::optional<int> depth;
+    std::optional<std::uint64_t> nodes;
+    std::optional<int> milliseconds;
+    if (words.size() % 2 == 0) {
+        error("expected go [depth <plies>] [nodes <nodes>] [movetime <milliseconds>]");
+        return;
+    }
+    for (std::size_t i = 1; i + 1 < words.size(); i += 2) {
+        const std::string_view key = words[i];
+        const std::string_view value = words[i + 1];
+        bool parsed = false;
+        if (key == "depth") {
+            depth = parseNumber<int>(value);
+            parsed = depth.has_value() && depth.value() > 0;
+        } else if (key == "nodes") {
+            nodes = parseNumber<std::uint64_t>(value);
+            parsed = nodes.has_value();
+        } else if (key == "movetime") {
+            milliseconds = parseNumber<int>(value);
+            parsed = milliseconds.has_value() && milliseconds.value() >= 0;
+        } else {
+            error(std::format("unknown limit {}", key));
+            return;
+        }
+        // A limit that cannot be read fails the command rather than leaving the search unlimited
+        if (!parsed) {
+            error(std::format("invalid value {} for {}", value, key));
+            return;
+        }
+    }
+    const bool limited = depth.has_value() || nodes.has_value() || milliseconds.has_value();
+
+    std::optional<Action> best;
+    if (isOver()) {
+        best = std::nullopt;
+    } else if (const std::optional<BookEntry> entry = useBook ? getOpeningBooks().choose(*game) : std::nullopt; entry.has_value()) {
+        best = entry->action();
+        output << std::format("info book games {} score {:.1f}\n", entry->games, entry->scoreRate() * 100);
+    } else if (useMcts) {
+        const int thinkMilliseconds = limited ? milliseconds.value_or(settings.thinkMilliseconds) : settings.thinkMilliseconds;
+        const MctsResult result = mctsSearcher.search(*game, {thinkMilliseconds / 1000.0, settings.searchThreads,
+                                                              static_cast<std::size_t>(settings.tableMegabytes)});
+        best = result.bestAction;
+        output << std::format("info winrate {:.3f} playouts {} time {:.0f} pps {:.0f}\n",
+                              result.winRate, result.playouts, result.seconds * 1000, result.playoutsPerSecond());
+    } else {
+        SearchLimits limits{settings.searchDepth, static_cast<std::uint64_t>(settings.searchNodes)};
+        if (limited) {
+            limits = {depth.value_or(MAX_SEARCH_DEPTH), nodes.value_or(UINT64_MAX), milliseconds.value_or(0) / 1000.0};
+        }
+        SearchResult result;
+        if (scheduler->size() > 1) {
+            ParallelSearcher parallelSearcher(*scheduler, table);
+            result = parallelSearcher.search(*game, limits);
+        } else {
+            result = searcher->search(*game, limits);
+        }
+        best = result.bestAction;
+        output << std::format("info depth {} score {} nodes {} time {:.0f} nps {:.0f}\n",
+                              result.depth, result.score, result.nodes, result.seconds * 1000, result.nodesPerSecond());
+    }
+    output << "bestmove " << (best.has_value() ? actionToString(game->board, best.value()) : "none") << std::endl;
+}
+
+/**
+ * @brief Answers "place" by placing a random powerup on a free powerup source, as the console game
+ * does every few turns, with "placed <placement>", or "placed none" if no source is free
+ */
+void Engine::place() {
+    const std::optional<std::pair<int, int>> coord = game->placePowerup();
+    if (!coord.has_value()) {
+        output << "placed none" << std::endl;
+        return;
+    }
+    const Placement placement{coord.value(), cellToPowerup(game->board.getCell(coord.value()))};
+    output << "placed " << placementToString(placement) << std::endl;
+}
+
+/**
+ * @brief Answers "d" with the board, the turn and the player to move
+ */
+void Engine::display() {
+    output << game->board.render() << "\n";
+    output << std::format("turn {} player {}{}", game->turnNumber, game->currentPlayerID, isOver() ? " over" : "") << std::endl;
+}
+
+/**
+ * @brief Reports a command that could not be run
+ * @param message What went wrong
+ */
+void Engine::error(const std::string_view message) {
+    output << "error " << message << std::endl;
+}
+
+/**
+ * @brief Checks if the game is over, which it is once the player to move has no dots left
+ */
+bool Engine::isOver() const {
+    return game->getAllyPlayer().numPieces == 0;
+}
+
+/**
+ * @brief Runs an engine session, reading one command per line until "quit" or the end of the input
+ * @param input The stream commands are read from
+ * @param output The stream responses are written to
+ * @note The protocol is described in README.md
+ */
+void runEngine(std::istream &input, std::ostream &output) {
+    Engine engine(output);
+    std::string line;
+    std::vector<std::string_view> words;
+    while (std::getline(input, line)) {
+        splitWords(line, words);
+        if (words.empty()) {
+            continue;
+        }
+        if (!engine.handle(words)) {
+            break;
+        }
+    }
+}
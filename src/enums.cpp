@@ -1,6 +1,6 @@
 #include "enums.h"
 
-#include <map>
+#include <stdexcept>
 #include <string>
 
 #include "cell.h"
@@ -21,6 +21,39 @@ std::string mapToString(const Map& map) {
     return "Unknown";
 }
 
+/**
+ * @brief Finds a map from its name
+ * @param name The name of the map, as shown in the settings
+ * @return The map
+ * @throws std::invalid_argument if no map has the name
+ */
+Map stringToMap(const std::string& name) {
+    for (int i = 0; i < static_cast<int>(Map::COUNT); i++) {
+        if (mapToString(static_cast<Map>(i)) == name) {
+            return static_cast<Map>(i);
+        }
+    }
+    throw std::invalid_argument("Unknown map: " + name);
+}
+
+/**
+ * @brief converts a player type into a string
+ * @param playerType The player type to convert
+ * @return The string representation of the player type
+ */
+std::string playerTypeToString(const PlayerType& playerType) {
+    switch (playerType) {
+        case PlayerType::HUMAN:
+            return "Human";
+        case PlayerType::COMPUTER:
+            return "Computer";
+        case PlayerType::MCTS:
+            return "Computer (MCTS)";
+        default:
+            return "Unknown";
+    }
+}
+
 /**
  * @brief converts a powerup into a string
  * @param powerup The powerup to convert
@@ -67,16 +100,18 @@ Cell PowerupToCell(Powerup powerup) {
  * @return The powerup representation of the cell
  */
 Powerup cellToPowerup(const Cell& cell) {
-    const std::map<Cell, Powerup> cellMap = {
-        {HOP_CELL, Powerup::HOP},
-        {DESTROYER_CELL, Powerup::DESTROYER},
-        {PORTAL_POWER_CELL, Powerup::PORTAL},
-        {BISHOP_POWER_CELL, Powerup::BISHOP},
-    };
-    if (!cellMap.contains(cell)) {
-        return Powerup::COUNT;
+    switch (cell.kind) {
+        case CellKind::HOP:
+            return Powerup::HOP;
+        case CellKind::DESTROYER:
+            return Powerup::DESTROYER;
+        case CellKind::PORTAL_POWER:
+            return Powerup::PORTAL;
+        case CellKind::BISHOP_POWER:
+            return Powerup::BISHOP;
+        default:
+            return Powerup::COUNT;
     }
-    return cellMap.at(cell);
 }
 
 Cell powerupToCell(const Powerup& powerup) {
@@ -0,0 +1,194 @@
+#include "evaluation.h"
+
+#include <algorithm>  // std::max, std::min
+#include <cstdlib>    // std::abs
+#include <filesystem>
+#include <stdexcept>
+#include <string>
+#include <utility>  // std::pair
+#include <vector>
+
+#include "globals.h"
+#include "other_tools.h"
+#include "player.h"
+
+const std::filesystem::path EVAL_WEIGHTS_PATH = EXE_PATH / "eval_weights.csv";
+
+// Offsets of the neighbours after a cell in row-major order, so each pair of neighbours is visited once
+const std::array<std::pair<int, int>, 4> FORWARD_NEIGHBOUR_OFFSETS = {{{0, 1}, {1, -1}, {1, 0}, {1, 1}}};
+
+/**
+ * @brief Gets the weight a key of the weights file sets
+ * @param weights The weights to look in
+ * @param key The key of the weight
+ * @return A pointer to the weight, or nullptr if the key is unknown
+ */
+int *findWeight(EvalWeights &weights, const std::string &key) {
+    if (key == "piece") return &weights.piece;
+    if (key == "bishop") return &weights.bishop;
+    if (key == "advance") return &weights.advance;
+    if (key == "centre") return &weights.centre;
+    if (key == "source_nearness") return &weights.sourceNearness;
+    if (key == "portal_adjacency") return &weights.portalAdjacency;
+    if (key == "max_valued_powerups") return &weights.maxValuedPowerups;
+    if (key == "hop_powerup") return &weights.powerups[static_cast<std::size_t>(Powerup::HOP)];
+    if (key == "destroyer_powerup") return &weights.powerups[static_cast<std::size_t>(Powerup::DESTROYER)];
+    if (key == "portal_powerup") return &weights.powerups[static_cast<std::size_t>(Powerup::PORTAL)];
+    if (key == "bishop_powerup") return &weights.powerups[static_cast<std::size_t>(Powerup::BISHOP)];
+    return nullptr;
+}
+
+/**
+ * @brief Reads evaluation weights from a CSV file of key,value rows
+ * @param path The path to the CSV file
+ * @return The weights, with the defaults kept for any key the file does not set
+ * @throws std::invalid_argument if a row has an unknown key or a value that is not an integer
+ */
+EvalWeights readEvalWeights(const std::filesystem::path &path) {
+    EvalWeights weights;
+    for (const std::vector<std::string> &row : import2D(path)) {
+        if (row.empty() || row[0].empty()) {
+            continue;
+        }
+        int *weight = findWeight(weights, row[0]);
+        if (weight == nullptr || row.size() != 2) {
+            throw std::invalid_argument("Invalid evaluation weight row '" + row[0] + "' in " + path.string());
+        }
+        try {
+            *weight = std::stoi(row[1]);
+        } catch (const std::exception &) {
+            throw std::invalid_argument("Evaluation weight '" + row[0] + "' is not an integer in " + path.string());
+        }
+    }
+    return weights;
+}
+
+/**
+ * @brief Gets the evaluation weights, read from EVAL_WEIGHTS_PATH the first time they are needed
+ * @return The weights, or the defaults if there is no weights file
+ */
+const EvalWeights &getEvalWeights() {
+    static const EvalWeights weights = std::filesystem::exists(EVAL_WEIGHTS_PATH) ? readEvalWeights(EVAL_WEIGHTS_PATH) : EvalWeights{};
+    return weights;
+}
+
+/**
+ * @brief Builds the evaluation tables of a board
+ * @param field The board's starting field, which fixes the powerup sources and each player's side
+ * @param weights The weights to build the tables with
+ * @return The tables, shared by every copy of the board
+ */
+std::shared_ptr<const EvalTables> buildEvalTables(const Field &field, const EvalWeights &weights) {
+    auto tables = std::make_shared<EvalTables>();
+    const int numCells = field.length * field.width;
+
+    // A player's side is the half of the board their pieces start in, found from the mean row of their pieces
+    std::array<long, 2> rowSums{};
+    std::array<long, 2> counts{};
+    std::vector<std::pair<int, int>> sources;
+    for (int i = 0; i < numCells; i++) {
+        const int row = i / field.width;
+        if (field.cells[i] == PLAYER_1_CELL || field.cells[i] == BISHOP_1_CELL) {
+            rowSums[0] += row;
+            counts[0]++;
+        } else if (field.cells[i] == PLAYER_2_CELL || field.cells[i] == BISHOP_2_CELL) {
+            rowSums[1] += row;
+            counts[1]++;
+        } else if (field.cells[i] == POWERUP_SOURCE_CELL) {
+            sources.emplace_back(row, i % field.width);
+        }
+    }
+    // Player 1 advances towards row 0 if their pieces start below player 2's, and towards the last row otherwise
+    const bool sidesKnown = counts[0] > 0 && counts[1] > 0;
+    const bool player1StartsBelow = sidesKnown && rowSums[0] * counts[1] > rowSums[1] * counts[0];
+
+    const std::array<std::pair<Cell, Cell>, 2> pieceCells = {{{PLAYER_1_CELL, BISHOP_1_CELL}, {PLAYER_2_CELL, BISHOP_2_CELL}}};
+    for (int player = 0; player < 2; player++) {
+        const auto feature = [player](const EvalFeature player1Feature) {
+            return static_cast<EvalFeature>(static_cast<std::size_t>(player1Feature) + player);
+        };
+        const bool startsBelow = player == 0 ? player1StartsBelow : !player1StartsBelow;
+        for (int i = 0; i < numCells; i++) {
+            const int row = i / field.width;
+            const int column = i % field.width;
+            const int advanced = !sidesKnown ? 0 : startsBelow ? field.length - 1 - row : row;
+            const int fromEdge = std::min(row, field.length - 1 - row) + std::min(column, field.width - 1 - column);
+            int nearness = 0;
+            for (const auto &[sourceRow, sourceColumn] : sources) {
+                const int distance = std::max(std::abs(sourceRow - row), std::abs(sourceColumn - column));
+                nearness += std::max(SOURCE_RADIUS - distance, 0);
+            }
+            for (const Cell &cell : {pieceCells[player].first, pieceCells[player].second}) {
+                Accumulator &square = tables->squares[cell.index()][i];
+                square[feature(EvalFeature::PLAYER_1_MATERIAL)] = weights.piece;
+                square[feature(EvalFeature::PLAYER_1_PLACEMENT)] = advanced * weights.advance + fromEdge * weights.centre;
+                square[feature(EvalFeature::PLAYER_1_SOURCES)] = nearness * weights.sourceNearness;
+            }
+            tables->squares[pieceCells[player].second.index()][i][feature(EvalFeature::PLAYER_1_BISHOPS)] = weights.bishop;
+        }
+        // Pairs are unordered, so each is stored both ways round
+        for (const Cell &cell : {pieceCells[player].first, pieceCells[player].second}) {
+            tables->pairs[cell.index()][PORTAL_CELL.index()][feature(EvalFeature::PLAYER_1_PORTALS)] = weights.portalAdjacency;
+            tables->pairs[PORTAL_CELL.index()][cell.index()][feature(EvalFeature::PLAYER_1_PORTALS)] = weights.portalAdjacency;
+        }
+    }
+    for (std::size_t kind = 0; kind < NUM_CELL_KINDS; kind++) {
+        for (std::size_t other = 0; other < NUM_CELL_KINDS; other++) {
+            if (tables->pairs[kind][other] != Accumulator{}) {
+                tables->pairedKinds[kind] |= std::uint16_t{1} << other;
+            }
+        }
+    }
+    return tables;
+}
+
+/**
+ * @brief Sums the evaluation terms of a whole field, which boards then keep up to date cell by cell
+ * @param field The field to sum
+ * @param tables The tables of the field's board
+ * @return The accumulator of the field
+ */
+Accumulator accumulateField(const Field &field, const EvalTables &tables) {
+    Accumulator accumulator;
+    for (int row = 0; row < field.length; row++) {
+        for (int column = 0; column < field.width; column++) {
+            const std::size_t kind = field.at({row, column}).index();
+            accumulator.add(tables.squares[kind][row * field.width + column]);
+            for (const auto &[rowOffset, columnOffset] : FORWARD_NEIGHBOUR_OFFSETS) {
+                const int neighbourRow = row + rowOffset;
+                const int neighbourColumn = column + columnOffset;
+                if (neighbourRow < field.length && neighbourColumn >= 0 && neighbourColumn < field.width) {
+                    accumulator.add(tables.pairs[kind][field.at({neighbourRow, neighbourColumn}).index()]);
+                }
+            }
+        }
+    }
+    return accumulator;
+}
+
+/**
+ * @brief Scores an accumulator from the view of player 1
+ * @param accumulator The accumulator to score
+ * @return The sum of player 1's features minus the sum of player 2's
+ */
+int accumulatorScore(const Accumulator &accumulator) {
+    int score = 0;
+    for (std::size_t i = 0; i < NUM_EVAL_FEATURES; i += 2) {
+        score += accumulator.lanes[i] - accumulator.lanes[i + 1];
+    }
+    return score;
+}
+
+/**
+ * @brief Scores the powerups a player holds
+ * @param player The player to score
+ * @param weights The weights to score with
+ * @return The value of the player's inventory, counting at most maxValuedPowerups of each powerup
+ */
+int inventoryScore(const Player &player, const EvalWeights &weights) {
+    int score = 0;
+    for (std::size_t i = 0; i < NUM_POWERUPS; i++) {
+        score += std::min<int>(player.inventory[i], weights.maxValuedPowerups) * weights.powerups[i];
+    }
+    return score;
+}
@@ -1,14 +1,11 @@
 #include "game.h"
 
 #include <algorithm>
+#include <array>
 #include <format>  // std::format
-#include <iostream>
 #include <map>
-#include <memory>  // std::shared_ptr
 #include <optional>
 #include <ranges>
-#include <set>
-#include <sstream>
 #include <string>
 #include <tuple>    // std::apply
 #include <utility>  // std::pair
@@ -17,26 +14,26 @@
 #include "board.h"
 #include "enums.h"
 #include "globals.h"
+#include "mcts.h"
+#include "opening_book.h"
 #include "other_tools.h"
-#include "portal.h"
+#include "parallel_search.h"
 #include "random.h"
-#include "validation_tools.h"
+#include "search.h"
+#include "transposition_table.h"
+#include "zobrist.h"
 
 /**
  * @brief Scans the board for pieces of a specific cell type
  * @param board The board to scan
  * @param targetCell The cell to scan for
- * @return A set of pieces with the target cell
- */
-std::set<Piece> scanPieces(const Board &board, const Cell &targetCell) {
-    std::set<Piece> pieces;
-    for (int i = 0; i < board.length; i++) {
-        for (int j = 0; j < board.width; j++) {
-            if (board.getCell({i, j}) == targetCell) {
-                pieces.emplace(std::pair<int, int>(i, j), targetCell, false);
-            }
-        }
-    }
+ * @return The pieces with the target cell
+ */
+std::vector<Piece> scanPieces(const Board &board, const Cell &targetCell) {
+    std::vector<Piece> pieces;
+    board.plane(targetCell).forEach([&board, &pieces, &targetCell](const int index) {
+        pieces.emplace_back(board.toCoord(index), targetCell, false);
+    });
     return pieces;
 }
 
@@ -46,33 +43,16 @@ std::set<Piece> scanPieces(const Board &board, const Cell &targetCell) {
  */
 Game::Game(const SettingsData &settingsData) : settings(settingsData),
                                                board(settingsData),
-                                               player1(std::make_shared<Player>(1, PLAYER_1_CELL, BISHOP_1_CELL, scanPieces(board, PLAYER_1_CELL))),
-                                               player2(std::make_shared<Player>(1, PLAYER_2_CELL, BISHOP_2_CELL, scanPieces(board, PLAYER_2_CELL))),
-                                               crumbliesCoords(board.scanCells(CRUMBLY_CELL)),
-                                               powerupSourceCoords(board.scanCells(POWERUP_SOURCE_CELL)),
-                                               barrierCoords(board.scanCells(BARRIER_CELL)) {}
-
-/**
- * @brief Prompts the user for a valid coordinate and edits it appropriately
- * @param prompt The prompt to display to the user
- * @param targetCell The character to check for at the coordinate
- * @param newCell The character to replace the targetCell with
- */
-std::optional<std::pair<int, int>> Game::editCoord(const std::string &prompt,
-                                                   const Cell &targetCell,
-                                                   const Cell &newCell) {
-    while (true) {
-        const auto coord = getValidCoord(prompt, board.length, board.length);
-        if (coord == std::nullopt) {
-            return std::nullopt;
-        }
-        // .value() returns the value of coord if it isn't std::nullopt, and throws an error otherwise
-        if (board.getCell(coord.value()) == targetCell) {
-            board.setCell(coord.value(), newCell);
-            return coord;
-        }
-        std::cout << "Coordinate does not correspond to " << targetCell.repr() << std::endl;
-    }
+                                               player1(1, PLAYER_1_CELL, BISHOP_1_CELL, scanPieces(board, PLAYER_1_CELL)),
+                                               player2(2, PLAYER_2_CELL, BISHOP_2_CELL, scanPieces(board, PLAYER_2_CELL)) {
+    board.plane(CRUMBLY_CELL).forEach([this](const int index) {
+        cellInfo[index].isCrumbly = true;
+    });
+    board.plane(POWERUP_SOURCE_CELL).forEach([this](const int index) {
+        cellInfo[index].isPowerupSource = true;
+        hasPowerupSources = true;
+    });
+    history.reserve(MAX_HISTORY);
 }
 
 /**
@@ -82,60 +62,267 @@ std::optional<std::pair<int, int>> Game::editCoord(const std::string &prompt,
  * @throws std::invalid_argument if the coordinate is not a member of the board's portals
  */
 std::pair<int, int> Game::updatePortals(const std::pair<int, int> &coord) {
-    for (const auto &portal : portals) {
-        if (portal.isMember(coord)) {
-            board.replaceCell(coord, REGULAR_CELL);
-            const std::pair<int, int> destination = portal.getOpposite(coord);
-            // remove portal from the set of portals
-            portals.erase(portal);
-            // return the exit of the portal
-            return destination;
-        }
+    const std::optional<std::pair<int, int>> destination = getPortalPartner(coord);
+    if (!destination.has_value()) {
+        throw std::invalid_argument("Coordinate is not a portal: " + coordToString(coord));
     }
-    throw std::invalid_argument("Coordinate is not a portal: " + coordToString(coord));
+    board.replaceCell(coord, REGULAR_CELL);
+    // remove the portal pair, both ends are used up
+    removePortal(coord, destination.value());
+    // return the exit of the portal
+    return destination.value();
+}
+
+/**
+ * @brief Checks if a cell crumbles when a piece leaves it
+ * @param coord The coordinate of the cell
+ */
+bool Game::isCrumbly(const std::pair<int, int> &coord) const {
+    return cellInfo[board.toIndex(coord)].isCrumbly;
+}
+
+/**
+ * @brief Checks if a cell is a powerup source
+ * @param coord The coordinate of the cell
+ */
+bool Game::isPowerupSource(const std::pair<int, int> &coord) const {
+    return cellInfo[board.toIndex(coord)].isPowerupSource;
 }
 
 /**
- * @brief Processes a move by updating the board and inventories
+ * @brief Gets the other end of the portal on a cell
+ * @param coord The coordinate of the cell
+ * @return The coordinate of the other end, or std::nullopt if there is no portal on the cell
+ */
+std::optional<std::pair<int, int>> Game::getPortalPartner(const std::pair<int, int> &coord) const {
+    const std::uint8_t partner = cellInfo[board.toIndex(coord)].portalPartner;
+    if (partner == NO_PORTAL) {
+        return std::nullopt;
+    }
+    return board.toCoord(partner);
+}
+
+/**
+ * @brief Moves a piece of the current player and resolves the cell it lands on, without any I/O
  * @param origin The origin of the move
  * @param destination The destination of the move
- * @note If the destination is a powerup, it is added to the player's inventory
- */
-void Game::processMove(const std::pair<int, int> &origin, std::pair<int, int> &destination) {
-    // destination cannot be const because it may be updated by updatePortals
-    // If the origin is a crumbly cell, remove it from the set of crumbly cells
-    const auto originCell = board.getCell(origin);
-    if (crumbliesCoords.contains(origin)) {
-        crumbliesCoords.erase(origin);
+ * @param record The undo record to fill in with what the move changed
+ */
+void Game::movePiece(const std::pair<int, int> &origin, const std::pair<int, int> &destination, UndoRecord &record) {
+    // If the origin is a crumbly cell, it crumbles away as the piece leaves
+    const Cell originCell = board.getCell(origin);
+    record.originCell = originCell;
+    CellInfo &originInfo = cellInfo[board.toIndex(origin)];
+    record.crumbled = originInfo.isCrumbly;
+    record.pickup = Powerup::COUNT;
+    if (record.crumbled) {
+        originInfo.isCrumbly = false;
         board.replaceCell(origin, BLANK_CELL);
-    } else if (powerupSourceCoords.contains(origin)) {
+    } else if (originInfo.isPowerupSource) {
         board.replaceCell(origin, POWERUP_SOURCE_CELL);
     } else {  // otherwise, replace the origin with a regular cell
         board.replaceCell(origin, REGULAR_CELL);
     }
 
     // handle actions based on the destination cell
-    if (const Cell destinationCell = board.getCell(destination); destinationCell == DESTROYER_CELL) {
-        getAllyPlayer()->addPowerup(Powerup::DESTROYER);
-        std::cout << std::format("Player {} has found a Destroyer!", currentPlayerID) << std::endl;
-    } else if (destinationCell == HOP_CELL) {
-        getAllyPlayer()->addPowerup(Powerup::HOP);
-        std::cout << std::format("Player {} has found a Hop!", currentPlayerID) << std::endl;
-    } else if (destinationCell == BISHOP_POWER_CELL) {
-        getAllyPlayer()->addPowerup(Powerup::BISHOP);
-        std::cout << std::format("Player {} has found a Bishop!", currentPlayerID) << std::endl;
-    } else if (destinationCell == PORTAL_POWER_CELL) {
-        getAllyPlayer()->addPowerup(Powerup::PORTAL);
-        std::cout << std::format("Player {} has found a Portal!", currentPlayerID) << std::endl;
+    std::pair<int, int> landing = destination;
+    const Cell destinationCell = board.getCell(destination);
+    record.destinationCell = destinationCell;
+    if (const Powerup pickup = cellToPowerup(destinationCell); pickup != Powerup::COUNT) {
+        getAllyPlayer().addPowerup(pickup);
+        record.pickup = pickup;
     } else if (destinationCell == PORTAL_CELL) {
-        destination = updatePortals(destination);
-    } else if (destinationCell == getTargetCell()) {
+        landing = updatePortals(destination);
+    } else if (destinationCell == getTargetCell() || destinationCell == getTargetBishopCell()) {
         // capture their piece
-        getTargetPlayer()->removePiece(destination);
+        getTargetPlayer().removePiece(destination);
     }
     // move the dot to the destination, and update the player's piece
-    board.replaceCell(destination, originCell);
-    getAllyPlayer()->updatePiece(origin, destination);
+    record.landing = static_cast<std::uint8_t>(board.toIndex(landing));
+    board.replaceCell(landing, originCell);
+    getAllyPlayer().updatePiece(origin, landing);
+}
+
+/**
+ * @brief Reverses a move made by movePiece
+ * @param record The undo record filled in by movePiece
+ * @note The current player must be the player who made the move
+ */
+void Game::unmovePiece(const UndoRecord &record) {
+    const std::pair<int, int> origin = board.toCoord(record.action.origin);
+    const std::pair<int, int> destination = board.toCoord(record.action.target);
+    const std::pair<int, int> landing = board.toCoord(record.landing);
+    getAllyPlayer().updatePiece(landing, origin);
+    board.replaceCell(origin, record.originCell);
+    if (record.crumbled) {
+        cellInfo[record.action.origin].isCrumbly = true;
+    }
+    if (record.destinationCell == PORTAL_CELL) {
+        // restore both ends of the consumed portal
+        board.replaceCell(landing, PORTAL_CELL);
+        board.replaceCell(destination, PORTAL_CELL);
+        addPortal(destination, landing);
+        return;
+    }
+    board.replaceCell(destination, record.destinationCell);
+    if (record.pickup != Powerup::COUNT) {
+        getAllyPlayer().removePowerup(record.pickup);
+    } else if (record.destinationCell == getTargetCell() || record.destinationCell == getTargetBishopCell()) {
+        getTargetPlayer().addPiece(Piece(destination, record.destinationCell, record.destinationCell == getTargetBishopCell()));
+    }
+}
+
+/**
+ * @brief Links two cells as the ends of a portal pair
+ * @param coord_1 The first portal coordinate
+ * @param coord_2 The second portal coordinate
+ */
+void Game::addPortal(const std::pair<int, int> &coord_1, const std::pair<int, int> &coord_2) {
+    const int index_1 = board.toIndex(coord_1);
+    const int index_2 = board.toIndex(coord_2);
+    cellInfo[index_1].portalPartner = static_cast<std::uint8_t>(index_2);
+    cellInfo[index_2].portalPartner = static_cast<std::uint8_t>(index_1);
+    togglePortalHashes(index_1, index_2);
+}
+
+/**
+ * @brief XORs the key of a portal pair into the portal hash under every symmetry
+ * @param index_1 The cell index of one end of the portal
+ * @param index_2 The cell index of the other end of the portal
+ */
+void Game::togglePortalHashes(const int index_1, const int index_2) {
+    for (std::size_t i = 0; i < NUM_SYMMETRIES; i++) {
+        const auto symmetry = static_cast<Symmetry>(i);
+        portalHashes[i] ^= portalKey(board.symmetries.transform(index_1, symmetry), board.symmetries.transform(index_2, symmetry));
+    }
+}
+
+/**
+ * @brief Unlinks the two ends of a portal pair
+ * @param coord_1 The first portal coordinate
+ * @param coord_2 The second portal coordinate
+ */
+void Game::removePortal(const std::pair<int, int> &coord_1, const std::pair<int, int> &coord_2) {
+    const int index_1 = board.toIndex(coord_1);
+    const int index_2 = board.toIndex(coord_2);
+    cellInfo[index_1].portalPartner = NO_PORTAL;
+    cellInfo[index_2].portalPartner = NO_PORTAL;
+    togglePortalHashes(index_1, index_2);
+}
+
+/**
+ * @brief Applies an action for the current player, records how to undo it and passes the turn
+ * @param action The action to apply, which must be legal (see generateActions)
+ * @note Performs no I/O and, once the history has been reserved, no allocation
+ */
+void Game::makeMove(const Action &action) {
+    applyAction(action, history.emplace_back());
+    currentPlayerID = 3 - currentPlayerID;
+    turnNumber++;
+}
+
+/**
+ * @brief Applies an action for the current player without passing the turn
+ * @param action The action to apply, which must be legal (see generateActions)
+ * @param record The undo record to fill in with what the action changed
+ */
+void Game::applyAction(const Action &action, UndoRecord &record) {
+    record.action = action;
+    record.crumbled = false;
+    record.pickup = Powerup::COUNT;
+    const std::pair<int, int> origin = board.toCoord(action.origin);
+    Player &player = getAllyPlayer();
+    switch (action.type) {
+        case ActionType::MOVE:
+            movePiece(origin, board.toCoord(action.target), record);
+            break;
+        case ActionType::HOP:
+            movePiece(origin, board.toCoord(action.target), record);
+            player.removePowerup(Powerup::HOP);
+            break;
+        case ActionType::PORTAL:
+            board.replaceCell(origin, PORTAL_CELL);
+            board.replaceCell(board.toCoord(action.target), PORTAL_CELL);
+            addPortal(origin, board.toCoord(action.target));
+            player.removePowerup(Powerup::PORTAL);
+            break;
+        case ActionType::DESTROYER:
+            board.replaceCell(origin, REGULAR_CELL);
+            player.removePowerup(Powerup::DESTROYER);
+            break;
+        case ActionType::BISHOP:
+            player.upgradePiece(Piece(origin, player.cell, false));
+            board.replaceCell(origin, player.bishopCell);
+            player.removePowerup(Powerup::BISHOP);
+            break;
+        default:
+            break;
+    }
+}
+
+/**
+ * @brief Describes an action for the current player in words, e.g. "Move 1A to 1C"
+ * @param action The action to describe
+ * @return The description of the action
+ */
+std::string Game::describeAction(const Action &action) const {
+    const std::string origin = coordToString(board.toCoord(action.origin));
+    const std::string target = coordToString(board.toCoord(action.target));
+    switch (action.type) {
+        case ActionType::MOVE:
+            return std::format("Move {} to {}", origin, target);
+        case ActionType::HOP:
+            return std::format("Hop {} to {}", origin, target);
+        case ActionType::PORTAL:
+            return std::format("Place a portal between {} and {}", origin, target);
+        case ActionType::DESTROYER:
+            return std::format("Destroy the barrier at {}", origin);
+        case ActionType::BISHOP:
+            return std::format("Upgrade the piece at {} to a bishop", origin);
+        default:
+            return "Unknown action";
+    }
+}
+
+/**
+ * @brief Reverses the last action applied by makeMove, including passing the turn
+ */
+void Game::unmakeMove() {
+    const UndoRecord record = history.back();
+    history.pop_back();
+    currentPlayerID = 3 - currentPlayerID;
+    turnNumber--;
+    const Action &action = record.action;
+    const std::pair<int, int> origin = board.toCoord(action.origin);
+    Player &player = getAllyPlayer();
+    switch (action.type) {
+        case ActionType::MOVE:
+            unmovePiece(record);
+            break;
+        case ActionType::HOP:
+            player.addPowerup(Powerup::HOP);
+            unmovePiece(record);
+            break;
+        case ActionType::PORTAL: {
+            const std::pair<int, int> target = board.toCoord(action.target);
+            removePortal(origin, target);
+            board.replaceCell(origin, REGULAR_CELL);
+            board.replaceCell(target, REGULAR_CELL);
+            player.addPowerup(Powerup::PORTAL);
+            break;
+        }
+        case ActionType::DESTROYER:
+            board.replaceCell(origin, BARRIER_CELL);
+            player.addPowerup(Powerup::DESTROYER);
+            break;
+        case ActionType::BISHOP:
+            player.downgradePiece(origin);
+            board.replaceCell(origin, player.cell);
+            player.addPowerup(Powerup::BISHOP);
+            break;
+        default:
+            break;
+    }
 }
 
 /**
@@ -144,154 +331,191 @@ void Game::processMove(const std::pair<int, int> &origin, std::pair<int, int> &d
  * @note A player loses if they have no dots left
  */
 bool Game::checkDefeat() const {
-    return getTargetPlayer()->pieces.empty();
+    return (board.plane(getTargetCell()) | board.plane(getTargetBishopCell())).none();
 }
 
 /**
- * @brief Prompts the user to use a powerup
- * @return True if a powerup was used, false otherwise
+ * @brief Places a powerup on the board at a random powerup source cell
+ * @param random The generator to draw the source and the powerup from
+ * @return The coordinate of the placed powerup, or std::nullopt if no powerup source cells are available
+ * @note Every free source cell is equally likely. Placing a powerup does not allocate, so
+ * searches can sample placements, and it is undone by replacing the cell with a powerup source
  */
-bool Game::usePowerup() {
-    const std::optional<Powerup> chosenPowerup = getAllyPlayer()->selectPowerup();
-    if (!chosenPowerup.has_value()) {
-        return false;
-    } else if (chosenPowerup.value() == Powerup::PORTAL) {
-        const std::optional<std::pair<int, int>> coord_1 = editCoord("Enter the first portal coordinate", REGULAR_CELL, PORTAL_CELL);
-        if (!coord_1.has_value()) {
-            return false;
-        }
-        const std::optional<std::pair<int, int>> coord_2 = editCoord("Enter the second portal coordinate", REGULAR_CELL, PORTAL_CELL).value();
-        if (!coord_2.has_value()) {
-            board.replaceCell(coord_1.value(), REGULAR_CELL);  // undo the first portal
-            return false;
-        }
-        portals.emplace(coord_1.value(), coord_2.value());
-    } else if (chosenPowerup.value() == Powerup::HOP) {
-        auto originDest = getAllyPlayer()->attemptMove(board, true);
-        if (!originDest.has_value()) {
-            return false;
-        }
-        auto [origin, destination] = originDest.value();
-        processMove(origin, destination);
-    } else if (chosenPowerup.value() == Powerup::DESTROYER && !editCoord("Which barrier would you like to destroy?", BARRIER_CELL, REGULAR_CELL).has_value()) {
-        return false;
-    } else if (chosenPowerup.value() == Powerup::BISHOP) {
-        auto chosenPiece = getAllyPlayer()->selectPiece();
-        if (!chosenPiece.has_value()) {
-            return false;
-        }
-        if (!getAllyPlayer()->upgradePiece(chosenPiece.value())) {
-            return false;
-        }
-        board.setCell(chosenPiece.value().coord, getAllyBishopCell());
+std::optional<std::pair<int, int>> Game::placePowerup(Random &random) {
+    const Bitboard &sourcePlane = board.plane(POWERUP_SOURCE_CELL);
+    const int numSources = sourcePlane.count();
+    if (numSources == 0) {
+        return std::nullopt;
     }
-    getAllyPlayer()->removePowerup(chosenPowerup.value());
-    return true;
+    int remaining = random.getInt(0, numSources - 1);
+    int chosen = 0;
+    sourcePlane.forEach([&remaining, &chosen](const int index) {
+        if (remaining-- == 0) {
+            chosen = index;
+        }
+    });
+    const std::pair<int, int> powerupCoord = board.toCoord(chosen);
+    placePowerup(powerupCoord, generateRandomPowerup(random));
+    return powerupCoord;
 }
 
 /**
- * @brief Prompts the user to save their score and saves it in the scores file
+ * @brief Places a chosen powerup on a powerup source cell
+ * @param coord The coordinate of the source, which must be free
+ * @param powerup The powerup to place
+ * @note Lets a controller replay the placements of a game instead of drawing them at random
  */
-void Game::scoreSave() const {
-    if (confirm("Would you like to save the score?")) {
-        std::vector<std::vector<std::string>> scores = import2D(SCORESPATH);
-        std::string scoreName = getValidString("Enter your names (c to cancel): ", 1, 20, "c", std::nullopt, std::set<char>{',', '\n'}).value();
-        scores.push_back({scoreName, std::to_string(board.length), std::to_string(board.width), std::to_string(settings.numDots), std::to_string(turnNumber)});
-        export2D(SCORESPATH, scores);
-    }
+void Game::placePowerup(const std::pair<int, int> &coord, const Powerup powerup) {
+    board.replaceCell(coord, powerupToCell(powerup));
 }
 
 /**
- * @brief Places a powerup on the board at a random powerup source cell
- * @note If no powerup source cells are available, the function does nothing
- */
-void Game::placePowerup() {
-    // Convert the set to a vector for shuffling
-    std::vector<std::pair<int, int>> potentialCells(powerupSourceCoords.begin(), powerupSourceCoords.end());
-    Random::getInstance().shuffleVector(potentialCells);
-    for (const auto &powerupCoord : potentialCells) {
-        if (board.getCell(powerupCoord) == POWERUP_SOURCE_CELL) {
-            // Get random powerup
-            const Powerup newPowerup = generateRandomPowerup();
-            // Replace the powerup source cell with the new powerup cell
-            board.replaceCell(powerupCoord, powerupToCell(newPowerup));
-            return;
-        }
-    }
+ * @brief Checks if powerups will be placed on the board as the game goes on
+ * @return False if placement is turned off or there are no powerup sources to place them on
+ */
+bool Game::placesPowerups() const {
+    return settings.powerupPlacementFrequency > 0 && hasPowerupSources;
 }
 
 /**
  * @brief Gets the cell of the current player
  */
 const Cell &Game::getTargetCell() const {
-    return getTargetPlayer()->cell;
+    return getTargetPlayer().cell;
 }
 
 /**
  * @brief Gets the bishop cell of the current opponent
  */
 const Cell &Game::getTargetBishopCell() const {
-    return getTargetPlayer()->bishopCell;
+    return getTargetPlayer().bishopCell;
 }
 
 /**
  * @brief Gets the cell of the current player
  */
 const Cell &Game::getAllyCell() const {
-    return getAllyPlayer()->cell;
+    return getAllyPlayer().cell;
 }
 
 /**
  * @brief Gets the bishop cell of the current player
  */
 const Cell &Game::getAllyBishopCell() const {
-    return getAllyPlayer()->bishopCell;
+    return getAllyPlayer().bishopCell;
 }
 
-const std::shared_ptr<Player> &Game::getTargetPlayer() const {
+/**
+ * @brief Gets the current opponent
+ */
+Player &Game::getTargetPlayer() {
     return currentPlayerID == 1 ? player2 : player1;
 }
 
-const std::shared_ptr<Player> &Game::getAllyPlayer() const {
+/**
+ * @brief Gets the current player
+ */
+Player &Game::getAllyPlayer() {
     return currentPlayerID == 1 ? player1 : player2;
 }
 
 /**
- * @brief Main game loop - plays the game until a player wins or concedes
+ * @brief Gets the current opponent
  */
-void Game::play() {
-    while (true) {
-        if (turnNumber % settings.powerupPlacementFrequency == 0) {
-            placePowerup();
-        }
-        board.show();
-        std::cout << std::format("Player {}'s turn  \t\tTurn: {}", currentPlayerID, turnNumber) << std::endl;
-        const int option = getValidInt("What would you like to do? \n1) Move\n2) Use a Powerup\n3) Concede", 1, 3);
-        if (option == 1) {
-            // can't be const because processMove may change destination
-            auto originDest = getAllyPlayer()->attemptMove(board, false);
-            if (!originDest.has_value()) {
-                continue;
-            }
-            auto [origin, destination] = originDest.value();
-            processMove(origin, destination);
-        } else if (option == 2 && !usePowerup()) {
-            continue;
-        } else if (option == 3) {
-            if (confirm("Are you sure you want to concede?")) {
-                std::cout << "Player " << currentPlayerID << " has conceded." << std::endl;
-                break;
-            } else {
-                continue;
-            }
+const Player &Game::getTargetPlayer() const {
+    return currentPlayerID == 1 ? player2 : player1;
+}
+
+/**
+ * @brief Gets the current player
+ */
+const Player &Game::getAllyPlayer() const {
+    return currentPlayerID == 1 ? player1 : player2;
+}
+
+/**
+ * @brief Gets the Zobrist hash of the current position
+ * @return The hash of the board, the side to move, both inventories and the portal pairs
+ * @note Every part is kept up to date as the game changes, so this is O(1)
+ */
+std::uint64_t Game::positionHash() const {
+    return symmetricHash(Symmetry::IDENTITY);
+}
+
+/**
+ * @brief Gets the Zobrist hash of the position a symmetry turns the current position into
+ * @param symmetry The symmetry to apply
+ * @return The hash, in O(1) as every part is kept up to date under every symmetry
+ */
+std::uint64_t Game::symmetricHash(const Symmetry symmetry) const {
+    const bool swapped = swapsColours(symmetry);
+    const int mover = swapped ? 3 - currentPlayerID : currentPlayerID;
+    const std::uint64_t sideHash = mover == 2 ? ZOBRIST_KEYS.sideToMove : 0;
+    const std::uint64_t inventoryHash = swapped ? player1.swappedInventoryHash ^ player2.swappedInventoryHash
+                                                : player1.inventoryHash ^ player2.inventoryHash;
+    const auto i = static_cast<std::size_t>(symmetry);
+    return board.hashes[i] ^ inventoryHash ^ portalHashes[i] ^ sideHash;
+}
+
+/**
+ * @brief Gets the key shared by the current position and every position a symmetry turns it into
+ * @return The smallest hash under any symmetry, with the symmetry that gives it. Actions stored
+ * against the key are transformed by that symmetry on the way in and on the way out
+ */
+CanonicalKey Game::canonicalKey() const {
+    CanonicalKey key{positionHash(), Symmetry::IDENTITY};
+    for (std::size_t i = 1; i < NUM_SYMMETRIES; i++) {
+        const auto symmetry = static_cast<Symmetry>(i);
+        if (const std::uint64_t hash = symmetricHash(symmetry); hash < key.hash) {
+            key = {hash, symmetry};
         }
-        if (checkDefeat()) {
-            board.show();
-            break;
+    }
+    return key;
+}
+
+/**
+ * @brief Gets who controls the current player
+ */
+PlayerType Game::getPlayerType() const {
+    return currentPlayerID == 1 ? settings.player1Type : settings.player2Type;
+}
+
+/**
+ * @brief Chooses the current player's action from the opening books, or by searching for it
+ * @param table The transposition table to search with
+ * @param scheduler The scheduler the alpha-beta search splits its work over
+ * @param mctsSearcher The Monte Carlo tree searcher, kept between turns so its arenas are reused
+ * @return The action and how it was chosen, or std::nullopt if the player has no legal actions
+ * @note The action is not applied, so front ends can report it first
+ */
+std::optional<ComputerChoice> Game::chooseComputerAction(TranspositionTable &table, TaskScheduler &scheduler, MctsSearcher &mctsSearcher) {
+    if (const std::optional<BookEntry> entry = getOpeningBooks().choose(*this); entry.has_value()) {
+        return ComputerChoice{entry->action(), std::format("opening book, played in {} games scoring {:.1f}%", entry->games, entry->scoreRate() * 100)};
+    }
+    if (getPlayerType() == PlayerType::MCTS) {
+        // The Monte Carlo tree gets the same memory budget as the transposition table
+        const MctsResult result = mctsSearcher.search(*this, {settings.thinkMilliseconds / 1000.0, settings.searchThreads,
+                                                              static_cast<std::size_t>(settings.tableMegabytes)});
+        if (!result.bestAction.has_value()) {
+            return std::nullopt;
         }
-        currentPlayerID = 3 - currentPlayerID;
-        turnNumber += 1;
+        return ComputerChoice{result.bestAction.value(),
+                              std::format("win rate {:.1f}%, {} playouts in {:.2f}s, {:.0f} playouts/s on {} threads",
+                                          result.winRate * 100, result.playouts, result.seconds, result.playoutsPerSecond(), settings.searchThreads)};
     }
-    std::cout << std::format("Player {} has won in {} turns!", currentPlayerID, turnNumber) << std::endl;
-    scoreSave();
-}
\ No newline at end of file
+    const SearchLimits limits{settings.searchDepth, static_cast<std::uint64_t>(settings.searchNodes)};
+    SearchResult result;
+    if (scheduler.size() > 1) {
+        ParallelSearcher searcher(scheduler, table);
+        result = searcher.search(*this, limits);
+    } else {
+        Searcher searcher(table);
+        result = searcher.search(*this, limits);
+    }
+    if (!result.bestAction.has_value()) {
+        return std::nullopt;
+    }
+    return ComputerChoice{result.bestAction.value(),
+                          std::format("depth {}, score {}, {} nodes in {:.2f}s, {:.0f} nodes/s",
+                                      result.depth, result.score, result.nodes, result.seconds, result.nodesPerSecond())};
+}
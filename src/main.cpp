@@ -1,11 +1,40 @@
+#include <algorithm>  // std::max
 #include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
 
+#include "bench.h"
+#include "console.h"
+#include "engine.h"
 #include "game.h"
 #include "globals.h"
+#include "opening_book.h"
 #include "other_tools.h"
+#include "proof_search.h"
+#include "random.h"
 #include "settings_data.h"
+#include "tablebase.h"
+#include "transposition_table.h"
 #include "validation_tools.h"
 
+// Depth searched by the parallel search benchmark when none is given
+const int DEFAULT_BENCH_DEPTH = 12;
+
+// Dots per side of a tablebase when none is given
+const int DEFAULT_TABLEBASE_DOTS = 2;
+
+// Self-play games an opening book is built from when none is given
+const int DEFAULT_BOOK_GAMES = 200;
+
+// Random playouts timed by the playout benchmark and their ply limit when none are given
+const int DEFAULT_PLAYOUT_GAMES = 100000;
+const int DEFAULT_PLAYOUT_PLIES = 200;
+
+// Nodes the proof search visits for each player and the size of its table when none are given
+const std::uint64_t DEFAULT_SOLVE_NODES = 10000000;
+const std::size_t DEFAULT_SOLVE_MEGABYTES = 256;
+
 /**
  * @brief Displays a welcome message in the console
  */
@@ -15,21 +44,99 @@ void welcomeMessage() {
     std::cout << std::string(21, '=') << "\n";
 }
 
+/**
+ * @brief Runs the command given on the command line instead of the interactive menu
+ * @param args The command line arguments after the program name
+ * @return The exit code of the program
+ */
+int runCommand(const std::vector<std::string> &args) {
+    try {
+        if (args[0] == "engine") {
+            // Responses are flushed once complete, so standard output need not be flushed before each read
+            std::ios::sync_with_stdio(false);
+            std::cin.tie(nullptr);
+            runEngine(std::cin, std::cout);
+            return 0;
+        }
+        if (args[0] == "bench") {
+            const int threads = args.size() > 1 ? std::stoi(args[1]) : static_cast<int>(std::max(std::thread::hardware_concurrency(), 1u));
+            const int depth = args.size() > 2 ? std::stoi(args[2]) : DEFAULT_BENCH_DEPTH;
+            benchParallelSearch(threads, depth, std::cout);
+            return 0;
+        }
+        if (args[0] == "playouts" && args.size() > 1) {
+            const int games = args.size() > 2 ? std::stoi(args[2]) : DEFAULT_PLAYOUT_GAMES;
+            const int plies = args.size() > 3 ? std::stoi(args[3]) : DEFAULT_PLAYOUT_PLIES;
+            benchPlayouts(stringToMap(args[1]), games, plies, std::cout);
+            return 0;
+        }
+        if (args[0] == "tablebase" && args.size() > 1) {
+            const int dots = args.size() > 2 ? std::stoi(args[2]) : DEFAULT_TABLEBASE_DOTS;
+            const int threads = args.size() > 3 ? std::stoi(args[3]) : static_cast<int>(std::max(std::thread::hardware_concurrency(), 1u));
+            generateTablebase(stringToMap(args[1]), dots, threads, std::cout);
+            return 0;
+        }
+        if (args[0] == "book" && args.size() > 1) {
+            const int games = args.size() > 2 ? std::stoi(args[2]) : DEFAULT_BOOK_GAMES;
+            const int threads = args.size() > 3 ? std::stoi(args[3]) : static_cast<int>(std::max(std::thread::hardware_concurrency(), 1u));
+            buildOpeningBook(stringToMap(args[1]), games, threads, std::cout);
+            return 0;
+        }
+        if (args[0] == "solve" && args.size() > 1) {
+            const std::uint64_t nodes = args.size() > 2 ? std::stoull(args[2]) : DEFAULT_SOLVE_NODES;
+            const int threads = args.size() > 3 ? std::stoi(args[3]) : static_cast<int>(std::max(std::thread::hardware_concurrency(), 1u));
+            const std::size_t megabytes = args.size() > 4 ? std::stoull(args[4]) : DEFAULT_SOLVE_MEGABYTES;
+            solveMap(stringToMap(args[1]), nodes, threads, megabytes, std::cout);
+            return 0;
+        }
+    } catch (const std::exception &e) {
+        std::cerr << "Invalid arguments: " << e.what() << std::endl;
+    }
+    std::cerr << "Usage: dotto-cpp [--seed <seed>] [engine | bench [threads] [depth] | playouts <map> [games] [plies] |\n"
+              << "                  tablebase <map> [dots] [threads] | book <map> [games] [threads] |\n"
+              << "                  solve <map> [nodes] [threads] [megabytes]]" << std::endl;
+    return 1;
+}
+
 /**
  * @brief Main function of the program
  */
-int main() {
+int main(int argc, char *argv[]) {
+    std::vector<std::string> args(argv + 1, argv + argc);
+    if (args.size() > 1 && args[0] == "--seed") {
+        // Every generator, map and computer player is seeded from this, so the run can be repeated exactly
+        try {
+            Random::setFixedSeed(std::stoull(args[1]));
+        } catch (const std::exception &) {
+            std::cerr << "Invalid seed: " << args[1] << std::endl;
+            return 1;
+        }
+        args.erase(args.begin(), args.begin() + 2);
+    }
+    if (!args.empty()) {
+        return runCommand(args);
+    }
     welcomeMessage();
+    showSkippedFiles();
     auto settingsData = SettingsData();
+    // Allocated once here and only reallocated if its size is changed in the settings
+    TranspositionTable table(settingsData.tableMegabytes, settingsData.useHugePages);
+    int tableMegabytes = settingsData.tableMegabytes;
+    bool useHugePages = settingsData.useHugePages;
     while (true) {
         const int option = getValidInt("What would you like to do? \n1) Play\n2) Edit settings\n3) View scores\n4) Exit", 1, 4);
         if (option == 1) {
+            if (settingsData.tableMegabytes != tableMegabytes || settingsData.useHugePages != useHugePages) {
+                tableMegabytes = settingsData.tableMegabytes;
+                useHugePages = settingsData.useHugePages;
+                table.resize(tableMegabytes, useHugePages);
+            }
             Game game(settingsData);
-            game.play();
+            playGame(game, table);
             std::cout << "Game over!\n"
                       << std::endl;
         } else if (option == 2) {
-            settingsData.edit();
+            editSettings(settingsData);
         } else if (option == 3) {
             showScores(import2D(SCORESPATH));
         } else if (option == 4) {
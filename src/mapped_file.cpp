@@ -0,0 +1,57 @@
+#include "mapped_file.h"
+
+#include <fstream>
+#include <stdexcept>
+
+#ifndef _WIN32
+#include <fcntl.h>     // open
+#include <sys/mman.h>  // mmap, munmap
+#include <sys/stat.h>  // fstat
+#include <unistd.h>    // close
+#endif
+
+/**
+ * @brief Opens a file
+ * @param path The path to the file
+ * @throws std::runtime_error if the file cannot be opened or is empty
+ */
+MappedFile::MappedFile(const std::filesystem::path &path) {
+#ifdef _WIN32
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file.is_open()) {
+        throw std::runtime_error("Could not open file: " + path.string());
+    }
+    numBytes = static_cast<std::size_t>(file.tellg());
+    contents.resize((numBytes + sizeof(std::uint64_t) - 1) / sizeof(std::uint64_t));
+    file.seekg(0);
+    file.read(reinterpret_cast<char *>(contents.data()), static_cast<std::streamsize>(numBytes));
+    bytes = reinterpret_cast<const std::byte *>(contents.data());
+#else
+    const int descriptor = open(path.c_str(), O_RDONLY);
+    if (descriptor < 0) {
+        throw std::runtime_error("Could not open file: " + path.string());
+    }
+    struct stat status{};
+    if (fstat(descriptor, &status) == 0 && status.st_size > 0) {
+        numBytes = static_cast<std::size_t>(status.st_size);
+        mapping = mmap(nullptr, numBytes, PROT_READ, MAP_PRIVATE, descriptor, 0);
+    }
+    close(descriptor);  // the mapping stays valid after the file is closed
+    if (mapping == nullptr || mapping == MAP_FAILED) {
+        mapping = nullptr;
+        throw std::runtime_error("Could not map file: " + path.string());
+    }
+    bytes = static_cast<const std::byte *>(mapping);
+#endif
+}
+
+/**
+ * @brief Destroy the Mapped File object, unmapping the file
+ */
+MappedFile::~MappedFile() {
+#ifndef _WIN32
+    if (mapping != nullptr) {
+        munmap(mapping, numBytes);
+    }
+#endif
+}
@@ -0,0 +1,311 @@
+#include "mcts.h"
+
+#include <algorithm>  // std::max
+#include <chrono>
+#include <cmath>  // std::log, std::sqrt
+#include <thread>
+
+#include "game.h"
+#include "move_generator.h"
+#include "random.h"
+#include "search.h"
+
+// Visits added to a node while a thread's playout through it is unfinished, counted as losses
+const int VIRTUAL_LOSS = 3;
+
+// Weight of exploration against exploitation when choosing a child
+const double EXPLORATION = 1.4;
+
+// Plies played by a playout before it is scored with the evaluation
+const int MAX_PLAYOUT_PLIES = 200;
+
+// Block size of the per-thread arenas
+const std::size_t ARENA_BLOCK_SIZE = std::size_t{1} << 20;
+
+/**
+ * @brief Gets the number of playouts run per second
+ */
+double MctsResult::playoutsPerSecond() const {
+    return seconds > 0.0 ? static_cast<double>(playouts) / seconds : 0.0;
+}
+
+/**
+ * @brief Checks if an action can be played in the current sample of an open loop tree
+ * @param game The game, positioned at the parent of the action
+ * @param action The action to check
+ * @return True if the player to move holds the powerup the action uses, or it uses none
+ * @note Two samples reached by the same actions only differ in where powerups were placed and so in
+ * what the players have picked up, so only the powerup each action uses needs checking
+ */
+bool isAvailable(const Game &game, const Action &action) {
+    const Player &player = game.getAllyPlayer();
+    switch (action.type) {
+        case ActionType::HOP:
+            return player.hasPowerup(Powerup::HOP);
+        case ActionType::PORTAL:
+            return player.hasPowerup(Powerup::PORTAL);
+        case ActionType::DESTROYER:
+            return player.hasPowerup(Powerup::DESTROYER);
+        case ActionType::BISHOP:
+            return player.hasPowerup(Powerup::BISHOP);
+        default:
+            return true;
+    }
+}
+
+/**
+ * @brief Plays an action and samples the powerup placement the game would make at the start of the next turn
+ * @param game The game to play on
+ * @param action The action to play
+ * @param placements The cell index of each ply's placed powerup, or -1 if none was placed, for undoing
+ */
+void playSampled(Game &game, const Action &action, std::vector<int> &placements) {
+    game.makeMove(action);
+    int placed = -1;
+    if (game.placesPowerups() && game.turnNumber % game.settings.powerupPlacementFrequency == 0) {
+        if (const auto coord = game.placePowerup(); coord.has_value()) {
+            placed = game.board.toIndex(coord.value());
+        }
+    }
+    placements.push_back(placed);
+}
+
+/**
+ * @brief Undoes every ply played by playSampled
+ * @param game The game to restore
+ * @param placements The placements recorded by playSampled, emptied
+ */
+void undoSampled(Game &game, std::vector<int> &placements) {
+    while (!placements.empty()) {
+        if (const int placed = placements.back(); placed >= 0) {
+            game.board.replaceCell(game.board.toCoord(placed), POWERUP_SOURCE_CELL);
+        }
+        placements.pop_back();
+        game.unmakeMove();
+    }
+}
+
+/**
+ * @brief Creates the children of a node, unless another thread is already doing so
+ * @param game The game, positioned at the node
+ * @param node The node to expand
+ * @param arena The arena to allocate the children from
+ * @param actions A list to generate the actions into
+ * @return True if this thread expanded the node
+ */
+bool expand(const Game &game, MctsNode &node, Arena &arena, ActionList &actions) {
+    NodeState expected = NodeState::UNEXPANDED;
+    if (!node.state.compare_exchange_strong(expected, NodeState::EXPANDING, std::memory_order_acquire)) {
+        return false;
+    }
+    actions.clear();
+    if (game.getAllyPlayer().numPieces > 0) {
+        generateActions(game, actions);
+    }
+    MctsNode *children = arena.allocate<MctsNode>(actions.size);
+    if (children == nullptr) {
+        node.state.store(NodeState::FULL, std::memory_order_release);
+        return false;
+    }
+    for (std::size_t i = 0; i < actions.size; i++) {
+        children[i].action = actions[i];
+    }
+    node.children = children;
+    node.numChildren = static_cast<std::uint32_t>(actions.size);
+    node.state.store(NodeState::EXPANDED, std::memory_order_release);
+    return true;
+}
+
+/**
+ * @brief Chooses the child to descend into with the UCT formula
+ * @param game The game, positioned at the node
+ * @param node The expanded node to choose from
+ * @return The chosen child, or nullptr if no child is available in this sample
+ * @note Unvisited children are always chosen first
+ */
+MctsNode *selectChild(const Game &game, MctsNode &node) {
+    const double logVisits = std::log(static_cast<double>(std::max(node.visits.load(std::memory_order_relaxed), 1)));
+    MctsNode *best = nullptr;
+    double bestValue = -1.0;
+    for (std::uint32_t i = 0; i < node.numChildren; i++) {
+        MctsNode &child = node.children[i];
+        if (!isAvailable(game, child.action)) {
+            continue;
+        }
+        const int visits = child.visits.load(std::memory_order_relaxed);
+        if (visits == 0) {
+            return &child;
+        }
+        const double value = child.score.load(std::memory_order_relaxed) / (2.0 * visits) +
+                             EXPLORATION * std::sqrt(logVisits / visits);
+        if (value > bestValue) {
+            bestValue = value;
+            best = &child;
+        }
+    }
+    return best;
+}
+
+/**
+ * @brief Plays a game out with a light policy: capture when possible, otherwise move at random
+ * @param game The game to play out
+ * @param actions A list to generate actions into
+ * @param placements The placements recorded by playSampled
+ * @return The ID of the winner, or 0 if the playout was cut off level
+ * @note Powerups other than hops are only used when a player has no moves left
+ */
+int playout(Game &game, ActionList &actions, std::vector<int> &placements) {
+    Random &random = Random::getInstance();
+    for (int ply = 0; ply < MAX_PLAYOUT_PLIES; ply++) {
+        const Player &player = game.getAllyPlayer();
+        if (player.numPieces == 0) {
+            return 3 - game.currentPlayerID;
+        }
+        actions.clear();
+        generatePieceMoves(game.board, player, false, actions);
+        if (player.hasPowerup(Powerup::HOP)) {
+            generatePieceMoves(game.board, player, true, actions);
+        }
+        if (actions.empty()) {
+            generateActions(game, actions);
+            if (actions.empty()) {
+                return 3 - game.currentPlayerID;
+            }
+        }
+        const std::size_t start = random.getInt(0, static_cast<int>(actions.size) - 1);
+        std::size_t chosen = start;
+        for (std::size_t i = 0; i < actions.size; i++) {
+            const std::size_t index = (start + i) % actions.size;
+            const Cell &target = game.board.field.cells[actions[index].target];
+            if (actions[index].type <= ActionType::HOP && (target == game.getTargetCell() || target == game.getTargetBishopCell())) {
+                chosen = index;
+                break;
+            }
+        }
+        playSampled(game, actions[chosen], placements);
+    }
+    const int score = evaluate(game);
+    return score > 0 ? game.currentPlayerID : score < 0 ? 3 - game.currentPlayerID : 0;
+}
+
+/**
+ * @brief Runs playouts on one thread until the search is stopped
+ * @param rootGame The game at the root of the tree, copied so the thread can play on its own game
+ * @param root The root of the shared tree
+ * @param arena The thread's arena to allocate nodes from
+ * @param deadline The time to stop searching
+ * @param playouts Set to the number of playouts run by this thread
+ */
+void MctsSearcher::runThread(const Game &rootGame, MctsNode &root, Arena &arena,
+                             const std::chrono::steady_clock::time_point deadline, std::uint64_t &playouts) {
+    Game game = rootGame;
+    game.history.reserve(MAX_HISTORY);
+    const auto actions = std::make_unique<ActionList>();
+    std::vector<MctsNode *> path;
+    std::vector<int> movers;  // ID of the player who made the action of each node on the path after the root
+    std::vector<int> placements;
+    path.reserve(MAX_HISTORY);
+    movers.reserve(MAX_HISTORY);
+    placements.reserve(MAX_HISTORY);
+    std::uint64_t count = 0;
+    while (!stopped.load(std::memory_order_relaxed)) {
+        if (std::chrono::steady_clock::now() >= deadline) {
+            stopped.store(true, std::memory_order_relaxed);
+            break;
+        }
+        // Descend the tree, adding a virtual loss to every node on the way
+        path.clear();
+        movers.clear();
+        MctsNode *node = &root;
+        node->visits.fetch_add(VIRTUAL_LOSS, std::memory_order_relaxed);
+        path.push_back(node);
+        while (true) {
+            const bool expandedHere = node->state.load(std::memory_order_acquire) == NodeState::UNEXPANDED &&
+                                      expand(game, *node, arena, *actions);
+            if (node->state.load(std::memory_order_acquire) != NodeState::EXPANDED) {
+                break;
+            }
+            MctsNode *child = selectChild(game, *node);
+            if (child == nullptr) {
+                break;
+            }
+            child->visits.fetch_add(VIRTUAL_LOSS, std::memory_order_relaxed);
+            movers.push_back(game.currentPlayerID);
+            playSampled(game, child->action, placements);
+            path.push_back(child);
+            node = child;
+            if (expandedHere) {
+                break;  // the tree grows by one level per playout
+            }
+        }
+
+        // Play out from the leaf, then replace the virtual losses with the real result
+        const int winner = playout(game, *actions, placements);
+        root.visits.fetch_add(1 - VIRTUAL_LOSS, std::memory_order_relaxed);
+        for (std::size_t i = 1; i < path.size(); i++) {
+            const int reward = winner == movers[i - 1] ? 2 : winner == 0 ? 1 : 0;
+            path[i]->score.fetch_add(reward, std::memory_order_relaxed);
+            path[i]->visits.fetch_add(1 - VIRTUAL_LOSS, std::memory_order_relaxed);
+        }
+        undoSampled(game, placements);
+        count++;
+    }
+    playouts = count;
+}
+
+/**
+ * @brief Searches for the best action of the player to move until the time limit
+ * @param game The game to search, which is not changed
+ * @param limits The time, thread and memory limits of the search
+ * @return The most visited action and statistics of the search
+ */
+MctsResult MctsSearcher::search(const Game &game, const MctsLimits &limits) {
+    const auto start = std::chrono::steady_clock::now();
+    const auto deadline = start + std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(limits.seconds));
+    const int numThreads = std::max(limits.threads, 1);
+    const std::size_t arenaCapacity = (limits.treeMegabytes << 20) / numThreads;
+    if (arenas.size() != static_cast<std::size_t>(numThreads) || arenas[0]->getCapacity() != arenaCapacity) {
+        arenas.clear();
+        for (int i = 0; i < numThreads; i++) {
+            arenas.push_back(std::make_unique<Arena>(arenaCapacity, ARENA_BLOCK_SIZE));
+        }
+    }
+    for (const auto &arena : arenas) {
+        arena->reset();  // release the previous search's tree all at once
+    }
+    stopped.store(false, std::memory_order_relaxed);
+
+    // Expanding the root up front means there is an action to return even if no playout finishes
+    MctsNode root;
+    const auto rootActions = std::make_unique<ActionList>();
+    expand(game, root, *arenas[0], *rootActions);
+    std::vector<std::uint64_t> playouts(numThreads, 0);
+    std::vector<std::thread> workers;
+    workers.reserve(numThreads - 1);
+    for (int i = 1; i < numThreads; i++) {
+        workers.emplace_back(&MctsSearcher::runThread, this, std::cref(game), std::ref(root), std::ref(*arenas[i]), deadline, std::ref(playouts[i]));
+    }
+    runThread(game, root, *arenas[0], deadline, playouts[0]);
+    for (std::thread &worker : workers) {
+        worker.join();
+    }
+
+    MctsResult result;
+    for (const std::uint64_t threadPlayouts : playouts) {
+        result.playouts += threadPlayouts;
+    }
+    if (root.state.load(std::memory_order_acquire) == NodeState::EXPANDED) {
+        const MctsNode *best = nullptr;
+        for (std::uint32_t i = 0; i < root.numChildren; i++) {
+            if (best == nullptr || root.children[i].visits > best->visits) {
+                best = &root.children[i];
+            }
+        }
+        if (best != nullptr) {
+            result.bestAction = best->action;
+            result.winRate = best->visits > 0 ? best->score / (2.0 * best->visits) : 0.0;
+        }
+    }
+    result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return result;
+}
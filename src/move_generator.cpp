@@ -0,0 +1,116 @@
+#include "move_generator.h"
+
+#include <cstdint>
+
+#include "cell.h"
+#include "enums.h"
+#include "slide_table.h"
+
+/**
+ * @brief Gets the index in SLIDE_VECTORS of the first of the four vectors a piece moves along
+ * @param isBishop Whether the piece is a bishop (diagonal vectors)
+ * @param isHop Whether a hop powerup is used (doubled vectors)
+ * @return The index of the first vector
+ */
+std::size_t firstSlideVector(const bool isBishop, const bool isHop) {
+    return (isBishop ? 4 : 0) + (isHop ? 8 : 0);
+}
+
+/**
+ * @brief Appends every move of a player's pieces to a list of actions
+ * @param board The game board
+ * @param player The player whose pieces move
+ * @param isHop Whether to generate hops instead of normal moves
+ * @param actions The list to append to
+ */
+void generatePieceMoves(const Board &board, const Player &player, const bool isHop, ActionList &actions) {
+    const ActionType type = isHop ? ActionType::HOP : ActionType::MOVE;
+    for (const Piece &piece : player.getPieces()) {
+        const int origin = board.toIndex(piece.coord());
+        const std::size_t firstVector = firstSlideVector(piece.isBishop, isHop);
+        for (std::size_t v = firstVector; v < firstVector + 4; v++) {
+            const std::uint8_t stop = board.slides.stop(v, origin);
+            if (stop == NO_STOP) {
+                continue;
+            }
+            if (const Cell &cell = board.field.cells[stop]; cell != BARRIER_CELL && cell != player.cell && cell != player.bishopCell) {
+                actions.push(type, origin, stop);
+            }
+        }
+    }
+}
+
+/**
+ * @brief Fills a list with every legal action of the player to move
+ * @param game The game to generate actions for
+ * @param actions The list to fill, cleared first
+ * @note Performs no heap allocation and no I/O, so it can be called in a loop
+ */
+void generateActions(const Game &game, ActionList &actions) {
+    actions.clear();
+    const Board &board = game.board;
+    const Player &player = game.getAllyPlayer();
+    generatePieceMoves(board, player, false, actions);
+    if (player.hasPowerup(Powerup::HOP)) {
+        generatePieceMoves(board, player, true, actions);
+    }
+    if (player.hasPowerup(Powerup::DESTROYER)) {
+        board.plane(BARRIER_CELL).forEach([&actions](const int index) {
+            actions.push(ActionType::DESTROYER, index);
+        });
+    }
+    if (player.hasPowerup(Powerup::BISHOP)) {
+        for (const Piece &piece : player.getPieces()) {
+            if (!piece.isBishop) {
+                actions.push(ActionType::BISHOP, board.toIndex(piece.coord()));
+            }
+        }
+    }
+    if (player.hasPowerup(Powerup::PORTAL)) {
+        // A portal joins any two distinct regular cells, each pair is generated once
+        const Bitboard &regularPlane = board.plane(REGULAR_CELL);
+        regularPlane.forEach([&regularPlane, &actions](const int first) {
+            regularPlane.forEach([first, &actions](const int second) {
+                if (second > first) {
+                    actions.push(ActionType::PORTAL, first, second);
+                }
+            });
+        });
+    }
+}
+
+/**
+ * @brief Fills a list with the moves and hops of the player to move that capture a piece or pick up a powerup
+ * @param game The game to generate actions for
+ * @param actions The list to fill, cleared first
+ * @note These are the actions that change the material balance, searched by quiescence search
+ */
+void generateNoisyActions(const Game &game, ActionList &actions) {
+    actions.clear();
+    const Board &board = game.board;
+    const Player &player = game.getAllyPlayer();
+    generatePieceMoves(board, player, false, actions);
+    if (player.hasPowerup(Powerup::HOP)) {
+        generatePieceMoves(board, player, true, actions);
+    }
+    std::size_t numNoisy = 0;
+    for (const Action &action : actions) {
+        if (isNoisy(game, action)) {
+            actions[numNoisy++] = action;
+        }
+    }
+    actions.size = numNoisy;
+}
+
+/**
+ * @brief Checks if an action captures a piece or picks up a powerup
+ * @param game The game, before the action
+ * @param action The action to check
+ */
+bool isNoisy(const Game &game, const Action &action) {
+    if (action.type != ActionType::MOVE && action.type != ActionType::HOP) {
+        return false;
+    }
+    const Cell &target = game.board.field.cells[action.target];
+    return target == game.getTargetCell() || target == game.getTargetBishopCell() || cellToPowerup(target) != Powerup::COUNT;
+}
@@ -0,0 +1,153 @@
+#include "notation.h"
+
+#include <cctype>
+#include <format>  // std::format
+#include <stdexcept>
+
+#include "cell.h"
+#include "other_tools.h"
+
+/**
+ * @brief Reads a coordinate from the front of some text, as written by coordToString
+ * @param board The board the coordinate must be on
+ * @param text The text, advanced past the coordinate
+ * @return The coordinate, or std::nullopt if the text does not start with one on the board
+ * @note Parsed by hand rather than with stringToCoord, so protocol words are read without allocating
+ */
+std::optional<std::pair<int, int>> readCoord(const Board &board, std::string_view &text) {
+    int column = 0;
+    std::size_t length = 0;
+    while (length < text.size() && std::isdigit(static_cast<unsigned char>(text[length]))) {
+        column = column * 10 + (text[length++] - '0');
+        if (column > MAX_BOARD_WIDTH) {
+            return std::nullopt;
+        }
+    }
+    const std::size_t digits = length;
+    int row = 0;
+    while (length < text.size() && std::isupper(static_cast<unsigned char>(text[length]))) {
+        row = row * 26 + (text[length++] - 'A' + 1);
+        if (row > MAX_BOARD_LENGTH) {
+            return std::nullopt;
+        }
+    }
+    if (digits == 0 || length == digits) {
+        return std::nullopt;
+    }
+    const std::pair<int, int> coord{row - 1, column - 1};
+    if (!board.isWithinBounds(coord)) {
+        return std::nullopt;
+    }
+    text.remove_prefix(length);
+    return coord;
+}
+
+/**
+ * @brief Writes an action in the protocol notation
+ * @param board The board the action is played on
+ * @param action The action to write
+ * @return The action as one word, e.g. "1A1C" or "p2B4D"
+ */
+std::string actionToString(const Board &board, const Action &action) {
+    const std::string origin = coordToString(board.toCoord(action.origin));
+    switch (action.type) {
+        case ActionType::MOVE:
+            return origin + coordToString(board.toCoord(action.target));
+        case ActionType::HOP:
+            return "h" + origin + coordToString(board.toCoord(action.target));
+        case ActionType::PORTAL:
+            return "p" + origin + coordToString(board.toCoord(action.target));
+        case ActionType::DESTROYER:
+            return "d" + origin;
+        case ActionType::BISHOP:
+            return "b" + origin;
+        default:
+            throw std::invalid_argument("Unknown action type");
+    }
+}
+
+/**
+ * @brief Reads an action written in the protocol notation
+ * @param board The board the action is played on
+ * @param text The word to read
+ * @return The action, or std::nullopt if the word is not an action on the board
+ * @note Only the notation is checked, not whether the action is legal
+ */
+std::optional<Action> stringToAction(const Board &board, std::string_view text) {
+    if (text.empty()) {
+        return std::nullopt;
+    }
+    ActionType type = ActionType::MOVE;
+    switch (text.front()) {
+        case 'h':
+            type = ActionType::HOP;
+            break;
+        case 'p':
+            type = ActionType::PORTAL;
+            break;
+        case 'd':
+            type = ActionType::DESTROYER;
+            break;
+        case 'b':
+            type = ActionType::BISHOP;
+            break;
+        default:
+            break;
+    }
+    if (type != ActionType::MOVE) {
+        text.remove_prefix(1);
+    }
+    const std::optional<std::pair<int, int>> origin = readCoord(board, text);
+    if (!origin.has_value()) {
+        return std::nullopt;
+    }
+    Action action{type, static_cast<std::uint8_t>(board.toIndex(origin.value())), 0};
+    if (type == ActionType::MOVE || type == ActionType::HOP || type == ActionType::PORTAL) {
+        const std::optional<std::pair<int, int>> target = readCoord(board, text);
+        if (!target.has_value()) {
+            return std::nullopt;
+        }
+        action.target = static_cast<std::uint8_t>(board.toIndex(target.value()));
+    }
+    if (!text.empty()) {
+        return std::nullopt;
+    }
+    return action;
+}
+
+/**
+ * @brief Writes a powerup placement in the protocol notation
+ * @param placement The placement to write
+ * @return The placement as one word, e.g. "+3CH"
+ */
+std::string placementToString(const Placement &placement) {
+    return std::format("+{}{}", coordToString(placement.coord), powerupToCell(placement.powerup).character());
+}
+
+/**
+ * @brief Reads a powerup placement written in the protocol notation
+ * @param board The board the powerup is placed on
+ * @param text The word to read
+ * @return The placement, or std::nullopt if the word is not a placement on the board
+ * @note Only the notation is checked, not whether the cell is a free powerup source
+ */
+std::optional<Placement> stringToPlacement(const Board &board, std::string_view text) {
+    if (text.size() < 2 || text.front() != '+') {
+        return std::nullopt;
+    }
+    // The powerup letter is split off first, as readCoord would take it as part of the row
+    const char character = text.back();
+    text.remove_prefix(1);
+    text.remove_suffix(1);
+    const std::optional<std::pair<int, int>> coord = readCoord(board, text);
+    if (!coord.has_value() || !text.empty()) {
+        return std::nullopt;
+    }
+    for (std::size_t i = 0; i < NUM_POWERUPS; i++) {
+        const auto powerup = static_cast<Powerup>(i);
+        if (powerupToCell(powerup).character() == character) {
+            return Placement{coord.value(), powerup};
+        }
+    }
+    return std::nullopt;
+}
@@ -0,0 +1,113 @@
+#include "opening_book.h"
+
+#include <algorithm>  // std::lower_bound, std::upper_bound, std::find
+#include <stdexcept>
+
+#include "game.h"
+#include "globals.h"
+#include "move_generator.h"
+
+const std::filesystem::path BOOK_DIRECTORY = EXE_PATH / "books";
+
+// Extension of opening book files
+const std::string BOOK_EXTENSION = ".book";
+
+// Fewest self-play games an action must have been played in to be chosen from a book
+const std::uint32_t MIN_BOOK_GAMES = 3;
+
+/**
+ * @brief Opens an opening book file
+ * @param path The path to the file
+ * @throws std::runtime_error if the file cannot be read or is not an opening book of this version
+ */
+OpeningBook::OpeningBook(const std::filesystem::path &path) : file(path) {
+    const auto *header = reinterpret_cast<const BookHeader *>(file.data());
+    if (file.size() < sizeof(BookHeader) || header->magic != BOOK_MAGIC || header->version != BOOK_VERSION ||
+        file.size() != sizeof(BookHeader) + header->numEntries * sizeof(BookEntry)) {
+        throw std::runtime_error("Not a valid opening book: " + path.string());
+    }
+    entries = reinterpret_cast<const BookEntry *>(file.data() + sizeof(BookHeader));
+    numEntries = header->numEntries;
+}
+
+/**
+ * @brief Looks up the actions played from a position by binary search
+ * @param hash The canonical hash of the position
+ * @return The entries of the position, empty if it is not in the book
+ */
+std::span<const BookEntry> OpeningBook::probe(const std::uint64_t hash) const {
+    const BookEntry *first = std::lower_bound(entries, entries + numEntries, hash, [](const BookEntry &entry, const std::uint64_t value) {
+        return entry.hash < value;
+    });
+    const BookEntry *last = std::upper_bound(first, entries + numEntries, hash, [](const std::uint64_t value, const BookEntry &entry) {
+        return value < entry.hash;
+    });
+    return {first, last};
+}
+
+/**
+ * @brief Opens every opening book in a directory
+ * @param directory The directory to look in, which need not exist
+ * @note Files that are not valid opening books are skipped and listed in getSkipped
+ */
+OpeningBookSet::OpeningBookSet(const std::filesystem::path &directory) {
+    std::error_code error;
+    if (!std::filesystem::is_directory(directory, error)) {
+        return;
+    }
+    for (const auto &file : std::filesystem::directory_iterator(directory, error)) {
+        if (file.path().extension() != BOOK_EXTENSION) {
+            continue;
+        }
+        try {
+            books.push_back(std::make_unique<OpeningBook>(file.path()));
+        } catch (const std::runtime_error &e) {
+            skipped.emplace_back(e.what());
+        }
+    }
+}
+
+/**
+ * @brief Chooses the book action of a position
+ * @param game The game to choose an action for
+ * @return The legal action played in the most self-play games, ties going to the best scoring, turned
+ * from the canonical position into this one, or std::nullopt if no book has an action for the
+ * position played in at least MIN_BOOK_GAMES games
+ * @note Actions are checked against the legal actions, so a hash collision never plays an illegal action
+ */
+std::optional<BookEntry> OpeningBookSet::choose(const Game &game) const {
+    if (books.empty()) {
+        return std::nullopt;
+    }
+    const CanonicalKey key = game.canonicalKey();
+    std::unique_ptr<ActionList> actions;  // Only generated once a candidate is found
+    std::optional<BookEntry> best;
+    for (const auto &book : books) {
+        for (BookEntry entry : book->probe(key.hash)) {
+            if (entry.games < MIN_BOOK_GAMES ||
+                (best.has_value() && (entry.games < best->games || (entry.games == best->games && entry.halfPoints <= best->halfPoints)))) {
+                continue;
+            }
+            if (actions == nullptr) {
+                actions = std::make_unique<ActionList>();
+                generateActions(game, *actions);
+            }
+            const Action action = game.board.symmetries.transform(entry.action(), key.symmetry);
+            if (std::find(actions->begin(), actions->end(), action) != actions->end()) {
+                entry.type = action.type;
+                entry.origin = action.origin;
+                entry.target = action.target;
+                best = entry;
+            }
+        }
+    }
+    return best;
+}
+
+/**
+ * @brief Gets the opening books, opened from BOOK_DIRECTORY the first time they are needed
+ */
+const OpeningBookSet &getOpeningBooks() {
+    static const OpeningBookSet books(BOOK_DIRECTORY);
+    return books;
+}
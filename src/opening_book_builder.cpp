@@ -0,0 +1,180 @@
+#include <algorithm>  // std::sort
+#include <format>     // std::format
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <stdexcept>
+#include <tuple>  // std::tie
+#include <vector>
+
+#include "game.h"
+#include "move_generator.h"
+#include "opening_book.h"
+#include "other_tools.h"
+#include "scheduler.h"
+#include "search.h"
+#include "transposition_table.h"
+
+// Plies at the start of each self-play game that are recorded in the book
+const int BOOK_PLIES = 12;
+
+// Plies after which an unfinished self-play game is scored by the evaluation
+const int MAX_SELF_PLAY_PLIES = 200;
+
+// Limits of the search choosing each self-play action
+const int SELF_PLAY_DEPTH = 4;
+const std::uint64_t SELF_PLAY_NODES = 20000;
+
+// Chance that an action within the book plies is chosen at random instead of searched, so the
+// games spread over different openings
+const float BOOK_EXPLORATION = 0.2f;
+
+// Size of the transposition table shared by every self-play search
+const std::size_t SELF_PLAY_TABLE_MEGABYTES = 16;
+
+/**
+ * @brief An action played in a self-play game, before the games are merged into book entries
+ */
+struct BookRecord {
+    std::uint64_t hash;
+    Action action;
+    std::uint32_t halfPoints;
+};
+
+/**
+ * @brief Plays a game of the computer player against itself
+ * @param game The game to play, from its first turn
+ * @param searcher The searcher choosing the actions
+ * @param actions A list to generate the actions into
+ * @param random The generator of the exploring actions
+ * @param records The list the book plies are appended to
+ * @note Powerups are placed as Game::play places them. A game still going after MAX_SELF_PLAY_PLIES
+ * is won by the player the evaluation favours
+ */
+void playSelfPlayGame(Game &game, Searcher &searcher, ActionList &actions, Random &random, std::vector<BookRecord> &records) {
+    const std::size_t firstRecord = records.size();
+    int winner = 0;
+    int ply = 0;
+    for (; ply < MAX_SELF_PLAY_PLIES; ply++) {
+        if (game.placesPowerups() && game.turnNumber % game.settings.powerupPlacementFrequency == 0) {
+            game.placePowerup(random);
+        }
+        generateActions(game, actions);
+        if (actions.empty()) {
+            winner = 3 - game.currentPlayerID;
+            break;
+        }
+        Action action;
+        if (ply < BOOK_PLIES && random.getFloat(0.0f, 1.0f) < BOOK_EXPLORATION) {
+            action = actions[random.getInt(0, static_cast<int>(actions.size) - 1)];
+        } else {
+            action = searcher.search(game, {SELF_PLAY_DEPTH, SELF_PLAY_NODES}).bestAction.value_or(actions[0]);
+        }
+        if (ply < BOOK_PLIES) {
+            const CanonicalKey key = game.canonicalKey();
+            records.push_back({key.hash, game.board.symmetries.transform(action, key.symmetry), 0});
+        }
+        game.makeMove(action);
+        if (game.getAllyPlayer().numPieces == 0) {
+            winner = 3 - game.currentPlayerID;
+            break;
+        }
+    }
+    if (ply == MAX_SELF_PLAY_PLIES) {
+        const int score = evaluate(game);
+        winner = score > 0 ? game.currentPlayerID : score < 0 ? 3 - game.currentPlayerID : 0;
+    }
+    // Player 1 plays the even plies
+    for (std::size_t i = firstRecord; i < records.size(); i++) {
+        const int mover = (i - firstRecord) % 2 == 0 ? 1 : 2;
+        records[i].halfPoints = winner == 0 ? 1 : winner == mover ? 2 : 0;
+    }
+}
+
+/**
+ * @brief Merges the actions of every self-play game into book entries
+ * @param records The actions played, sorted in place
+ * @return The entries, sorted by hash then action
+ */
+std::vector<BookEntry> mergeBookRecords(std::vector<BookRecord> &records) {
+    const auto key = [](const BookRecord &record) {
+        return std::tie(record.hash, record.action.type, record.action.origin, record.action.target);
+    };
+    std::sort(records.begin(), records.end(), [&key](const BookRecord &a, const BookRecord &b) {
+        return key(a) < key(b);
+    });
+    std::vector<BookEntry> entries;
+    for (const BookRecord &record : records) {
+        if (entries.empty() || entries.back().hash != record.hash || entries.back().action() != record.action) {
+            entries.push_back({record.hash, 0, 0, record.action.type, record.action.origin, record.action.target, {}});
+        }
+        entries.back().games++;
+        entries.back().halfPoints += record.halfPoints;
+    }
+    return entries;
+}
+
+/**
+ * @brief Builds an opening book for a map from games the computer player plays against itself
+ * @param map The map to play on, with the other settings at their defaults
+ * @param numGames The number of self-play games
+ * @param threads The number of threads to play the games on
+ * @param log The stream progress is reported to
+ * @return The path the book was written to
+ * @throws std::invalid_argument if the map is generated at random or no games are asked for
+ * @throws std::runtime_error if the book cannot be written
+ * @note The first BOOK_PLIES plies of every game are recorded against the canonical key of the
+ * position they were played from, with the score of the player who played them, so a position and
+ * its symmetric counterparts share their statistics
+ */
+std::filesystem::path buildOpeningBook(const Map &map, const int numGames, const int threads, std::ostream &log) {
+    if (map == Map::RANDOM) {
+        throw std::invalid_argument("Opening books can only be built for fixed maps");
+    }
+    if (numGames < 1) {
+        throw std::invalid_argument("At least one game must be played");
+    }
+    SettingsData settings;
+    settings.map = map;
+    const Game start(settings);
+
+    TranspositionTable table(SELF_PLAY_TABLE_MEGABYTES, false);
+    TaskScheduler scheduler(threads, 0);
+    // Each worker keeps its own searcher and action list between games
+    std::vector<std::unique_ptr<Searcher>> searchers;
+    std::vector<std::unique_ptr<ActionList>> actionLists;
+    for (int i = 0; i < scheduler.size(); i++) {
+        searchers.push_back(std::make_unique<Searcher>(table));
+        actionLists.push_back(std::make_unique<ActionList>());
+    }
+
+    log << std::format("Playing {} games on {} on {} threads", numGames, mapToString(map), threads) << std::endl;
+    std::vector<BookRecord> records;
+    std::mutex recordsMutex;
+    TaskGroup group;
+    for (int i = 0; i < numGames; i++) {
+        scheduler.spawn(group, [&start, &searchers, &actionLists, &records, &recordsMutex](Worker &worker) {
+            Game game = start;
+            game.history.reserve(MAX_HISTORY);
+            std::vector<BookRecord> gameRecords;
+            playSelfPlayGame(game, *searchers[worker.index], *actionLists[worker.index], worker.random, gameRecords);
+            const std::lock_guard<std::mutex> lock(recordsMutex);
+            records.insert(records.end(), gameRecords.begin(), gameRecords.end());
+        });
+    }
+    scheduler.wait(group);
+
+    const std::vector<BookEntry> entries = mergeBookRecords(records);
+    const BookHeader header{BOOK_MAGIC, BOOK_VERSION, 0, entries.size()};
+    std::filesystem::create_directories(BOOK_DIRECTORY);
+    const std::filesystem::path path = BOOK_DIRECTORY / std::format("{}.book", mapToString(map));
+    std::ofstream file(path, std::ios::binary);
+    file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    file.write(reinterpret_cast<const char *>(entries.data()), static_cast<std::streamsize>(entries.size() * sizeof(BookEntry)));
+    if (!file) {
+        throw std::runtime_error("Could not write opening book: " + path.string());
+    }
+    log << std::format("Recorded {} actions as {} book entries. Written to {}", records.size(), entries.size(), path.string()) << std::endl;
+    return path;
+}
@@ -5,21 +5,18 @@
 #include <filesystem>
 #include <format>
 #include <fstream>
-#include <iostream>
 #include <map>
 #include <numeric>
 #include <ranges>
 #include <sstream>
 #include <stdexcept>
 #include <string>
-#include <tabulate/table.hpp>
 #include <utility>
 #include <vector>
 
 #include "cell.h"
 #include "globals.h"  // for the EXE_PATH variable
 #include "random.h"
-#include "validation_tools.h"
 
 /**
  * @brief Converts a pair of integers to a string in the format "A1", "B2", etc.
@@ -82,14 +79,13 @@ std::pair<int, int> vectorAddition(const std::pair<int, int>& vector_1, const st
  * @brief Imports a 2D vector from a CSV file
  * @param path The path to the CSV file
  * @param processCell A function to process each cell in the CSV file
- * @return The 2D vector
+ * @return The 2D vector, empty if the file cannot be opened
  */
 template <typename T>
 std::vector<std::vector<T>> import2DTemplate(const std::filesystem::path& path, std::function<T(const std::string&)> processCell) {
     std::vector<std::vector<T>> result;
     std::ifstream file(path);
     if (!file.is_open()) {
-        std::cout << "Could not open file, returning empty vector: " << path << std::endl;
         return result;
     }
     std::string line;
@@ -131,20 +127,22 @@ std::vector<std::vector<char>> importChar2D(const std::filesystem::path& path) {
 /**
  * @brief Converts a map type to a string by reading from a file
  * @param mapType The map type to convert
- * @return The vector form of the map (field)
+ * @return The field form of the map
+ * @throws std::invalid_argument if the map is empty or its rows are not all the same width
  */
-std::vector<std::vector<Cell>> readMap(const Map& mapType) {
+Field readMap(const Map& mapType) {
     const std::filesystem::path mapPath = EXE_PATH / std::format("maps/{}.csv", mapToString(mapType));
-    auto map = importChar2D(mapPath);
-    std::vector<std::vector<Cell>> field;
-    field.reserve(map.size());  // Preallocate space for the outer vector
-    for (const auto& row : map) {
-        std::vector<Cell> fieldRow;
-        fieldRow.reserve(row.size());  // Preallocate space for the inner vector
-        for (const auto& character : row) {
-            fieldRow.push_back(charToCell(character));
+    const auto map = importChar2D(mapPath);
+    if (map.empty() || map[0].empty()) {
+        throw std::invalid_argument("Map is empty: " + mapPath.string());
+    }
+    Field field(static_cast<int>(map.size()), static_cast<int>(map[0].size()), REGULAR_CELL);
+    for (int i = 0; i < field.length; i++) {
+        if (map[i].size() != map[0].size()) {
+            throw std::invalid_argument("Map rows must all be the same width: " + mapPath.string());
         }
-        field.push_back(fieldRow);
+        // Write each converted character straight into the row view of the field
+        std::ranges::transform(map[i], field[i].begin(), charToCell);
     }
     return field;
 }
@@ -171,20 +169,6 @@ void export2D(const std::filesystem::path& path, const std::vector<std::vector<s
     file.close();
 }
 
-/**
- * @brief Displays a 2D vector of strings as a table
- * @param scores The 2D vector of strings to display
- * @note Uses the tabulate library to display the table
- */
-void showScores(const std::vector<std::vector<std::string>>& scores) {
-    tabulate::Table table;
-    table.add_row({"Name", "Length", "Width", "Dots", "Turns"});
-    std::ranges::for_each(scores, [&table](const auto& row) {
-        table.add_row({row.begin(), row.end()});
-    });
-    std::cout << table << std::endl;
-}
-
 /**
  * @brief Converts a pair of integers to a verbose string in the format "(0, 0) : A1"
  * @param coord The pair of integers to convert
@@ -194,43 +178,11 @@ std::string verboseCoord(const std::pair<int, int>& coord) {
     return std::format("({}, {}) : {} ", coord.first, coord.second, coordToString(coord));
 }
 
-/**
- * @brief Displays a pair of integers as a verbose string in the format "(0, 0) : A1"
- * @param coord The pair of integers to display
- * @note Uses the verboseCoord function to convert the pair to a string
- */
-void showCoord(const std::pair<int, int>& coord) {
-    std::cout << verboseCoord(coord) << std::endl;
-}
-
-/**
- * @brief Displays a map of characters to pairs of integers as a list of moves
- * @param moves The map of characters to pairs of integers to display
- * @note Uses the verboseCoord function to convert the pairs to strings
- */
-void showMoves(const std::map<char, std::pair<int, int>, std::less<>>& moves) {
-    std::cout << "Possible moves:\n";
-    for (const auto& [key, value] : moves) {
-        std::cout << key << " : " << verboseCoord(value) << "\n";
-    }
-}
-
-/**
- * @brief Prompts the user to choose a map using an integer menu
- * @returns The map type
- */
-Map getValidMap() {
-    std::string prompt = "Choose a map:";
-    for (int i = 0; i < static_cast<int>(Map::COUNT); i++) {
-        prompt += std::format("\n{}) {}", i + 1, mapToString(static_cast<Map>(i)));
-    }
-    return static_cast<Map>(getValidInt(prompt, 1, static_cast<int>(Map::COUNT)) - 1);
-}
-
 /**
  * @brief Generates a random powerup
+ * @param random The generator to draw from
  * @return A random powerup
  */
-Powerup generateRandomPowerup() {
-    return static_cast<Powerup>(Random::getInstance().getInt(0, static_cast<int>(Powerup::COUNT) - 1));
+Powerup generateRandomPowerup(Random& random) {
+    return static_cast<Powerup>(random.getInt(0, static_cast<int>(Powerup::COUNT) - 1));
 }
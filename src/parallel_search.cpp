@@ -0,0 +1,100 @@
+#include "parallel_search.h"
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+
+#include "move_generator.h"
+
+/**
+ * @brief Construct a new Parallel Searcher object
+ * @param scheduler The scheduler to run the search's tasks on
+ * @param table The transposition table shared by the workers
+ */
+ParallelSearcher::ParallelSearcher(TaskScheduler &scheduler, TranspositionTable &table)
+    : scheduler(scheduler), table(table), games(scheduler.size()) {
+    for (int i = 0; i < scheduler.size(); i++) {
+        searchers.push_back(std::make_unique<Searcher>(table, &shared));
+    }
+}
+
+/**
+ * @brief Searches a position with iterative deepening until a limit is reached
+ * @param game The game to search, which is not changed
+ * @param limits The limits of the search, the node limit is shared by every worker
+ * @return The best action found by the last completed iteration and statistics of the search
+ * @note Must be called from the thread that owns the scheduler
+ */
+SearchResult ParallelSearcher::search(const Game &game, const SearchLimits &limits) {
+    const auto start = std::chrono::steady_clock::now();
+    shared.cancellation.reset();
+    shared.nodes.store(0, std::memory_order_relaxed);
+    for (int i = 0; i < scheduler.size(); i++) {
+        searchers[i]->prepare(limits);
+        games[i].emplace(game);
+        games[i]->history.reserve(MAX_HISTORY);
+    }
+
+    SearchResult result;
+    const auto rootActions = std::make_unique<ActionList>();
+    generateActions(game, *rootActions);
+    pruneSymmetricActions(game, *rootActions);
+    if (std::optional<SearchResult> solved = searchers[0]->probeRoot(*games[0], *rootActions); solved.has_value()) {
+        solved->seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        return solved.value();
+    }
+    const CanonicalKey key = game.canonicalKey();
+    const std::optional<TableEntry> entry = probeCanonical(table, game, key, 0);
+    searchers[0]->orderActions(game, *rootActions, entry.has_value() ? entry->bestAction : std::nullopt);
+    if (!rootActions->empty()) {
+        result.bestAction = (*rootActions)[0];
+    }
+    for (int depth = 1; depth <= limits.maxDepth && !rootActions->empty(); depth++) {
+        // The eldest brother is searched alone so its score can bound every other action
+        const int eldestScore = searchers[0]->searchAction(*games[0], (*rootActions)[0], depth, -MATE_SCORE, MATE_SCORE);
+        if (searchers[0]->isStopped()) {
+            break;
+        }
+        std::atomic<int> alpha{eldestScore};
+        Action bestAction = (*rootActions)[0];
+        std::mutex bestMutex;
+        TaskGroup group;
+        for (std::size_t i = 1; i < rootActions->size; i++) {
+            scheduler.spawn(group, [this, &rootActions, &alpha, &bestAction, &bestMutex, depth, i](Worker &worker) {
+                Searcher &searcher = *searchers[worker.index];
+                if (searcher.isStopped()) {
+                    return;
+                }
+                const Action &action = (*rootActions)[i];
+                const int bound = alpha.load(std::memory_order_relaxed);
+                const int score = searcher.searchAction(*games[worker.index], action, depth, bound, MATE_SCORE);
+                if (searcher.isStopped() || score <= bound) {
+                    return;
+                }
+                std::lock_guard<std::mutex> lock(bestMutex);
+                if (score > alpha.load(std::memory_order_relaxed)) {
+                    alpha.store(score, std::memory_order_relaxed);
+                    bestAction = action;
+                }
+            });
+        }
+        scheduler.wait(group);
+        if (shared.cancellation.isCancelled()) {
+            break;  // an unfinished iteration may not have looked at the best action
+        }
+        const int score = alpha.load(std::memory_order_relaxed);
+        result.bestAction = bestAction;
+        result.score = score;
+        result.depth = depth;
+        storeCanonical(table, game, key, {score, depth, Bound::EXACT, bestAction}, 0);
+        moveToFront(*rootActions, bestAction);
+        if (score >= MATE_BOUND || score <= -MATE_BOUND) {
+            break;
+        }
+    }
+    for (const auto &searcher : searchers) {
+        result.nodes += searcher->getNodes();
+    }
+    result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return result;
+}
@@ -1,6 +1,5 @@
 #include "piece.h"
 
-#include <iostream>  // std::cout
 #include <set>
 #include <utility>  // std::pair
 
@@ -13,14 +12,18 @@
  * @param isBishop Whether the piece is a bishop
  */
 Piece::Piece(const std::pair<int, int> &coord, const Cell &cell, const bool isBishop)
-    : coord(coord), cell(cell), isBishop(isBishop) {}
+    : row(static_cast<std::int8_t>(coord.first)),
+      column(static_cast<std::int8_t>(coord.second)),
+      cell(cell),
+      isBishop(isBishop) {}
 
 /**
  * @brief Updates the position of the piece
  * @param newCoord The new coordinate of the piece
  */
 void Piece::updatePosition(const std::pair<int, int> &newCoord) {
-    coord = newCoord;
+    row = static_cast<std::int8_t>(newCoord.first);
+    column = static_cast<std::int8_t>(newCoord.second);
 }
 
 /**
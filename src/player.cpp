@@ -2,12 +2,10 @@
 
 #include <algorithm>
 #include <format>
-#include <iostream>  // std::cout
+#include <limits>
 #include <map>
 #include <optional>
-#include <ranges>
-#include <set>
-#include <sstream>
+#include <stdexcept>
 #include <string>
 #include <utility>  // std::pair
 #include <vector>
@@ -16,18 +14,40 @@
 #include "enums.h"
 #include "other_tools.h"
 #include "piece.h"
-#include "validation_tools.h"
+#include "zobrist.h"
 
+/**
+ * @brief Construct a new Player object
+ * @param id The ID of the player (1 or 2)
+ * @param cell The cell of the player's pieces
+ * @param bishopCell The cell of the player's bishops
+ * @param pieces The player's starting pieces
+ * @throws std::invalid_argument if there are more than MAX_PIECES pieces
+ */
 Player::Player(const int id, const Cell &cell, const Cell &bishopCell,
-               const std::set<Piece> &pieces)
-    : id(id), cell(cell), bishopCell(bishopCell), pieces(pieces) {}
+               const std::vector<Piece> &pieces)
+    : id(id), cell(cell), bishopCell(bishopCell) {
+    if (pieces.size() > MAX_PIECES) {
+        throw std::invalid_argument(std::format("A player cannot have more than {} pieces", MAX_PIECES));
+    }
+    for (auto &row : pieceIndex) {
+        row.fill(NO_PIECE);
+    }
+    std::ranges::for_each(pieces, [this](const Piece &piece) { addPiece(piece); });
+}
 
 /**
  * @brief Adds a powerup to the player's inventory
  * @param powerup The powerup to add
  */
 void Player::addPowerup(const Powerup &powerup) {
-    inventory.push_back(powerup);
+    auto &count = inventory[static_cast<std::size_t>(powerup)];
+    if (count == std::numeric_limits<std::uint8_t>::max()) {
+        return;
+    }
+    inventoryHash ^= inventoryKey(id, powerup, count) ^ inventoryKey(id, powerup, count + 1);
+    swappedInventoryHash ^= inventoryKey(3 - id, powerup, count) ^ inventoryKey(3 - id, powerup, count + 1);
+    count++;
 }
 
 /**
@@ -35,7 +55,23 @@ void Player::addPowerup(const Powerup &powerup) {
  * @param powerup The powerup to remove
  */
 void Player::removePowerup(const Powerup &powerup) {
-    vectorRemove(inventory, powerup);
+    // Only one copy is removed, the player may be holding several of the same powerup
+    auto &count = inventory[static_cast<std::size_t>(powerup)];
+    if (count == 0) {
+        return;
+    }
+    inventoryHash ^= inventoryKey(id, powerup, count) ^ inventoryKey(id, powerup, count - 1);
+    swappedInventoryHash ^= inventoryKey(3 - id, powerup, count) ^ inventoryKey(3 - id, powerup, count - 1);
+    count--;
+}
+
+/**
+ * @brief Gets the number of a powerup the player holds
+ * @param powerup The powerup to count
+ * @return The number held
+ */
+int Player::getPowerupCount(const Powerup &powerup) const {
+    return inventory[static_cast<std::size_t>(powerup)];
 }
 
 /**
@@ -44,7 +80,7 @@ void Player::removePowerup(const Powerup &powerup) {
  * @return True if the player has the powerup, false otherwise
  */
 bool Player::hasPowerup(const Powerup &powerup) const {
-    return std::ranges::find(inventory, powerup) != std::ranges::end(inventory);
+    return inventory[static_cast<std::size_t>(powerup)] > 0;
 }
 
 /**
@@ -52,53 +88,25 @@ bool Player::hasPowerup(const Powerup &powerup) const {
  * @return True if the player has powerups, false otherwise
  */
 bool Player::hasPowerups() const {
-    return !inventory.empty();
+    return std::ranges::any_of(inventory, [](const std::uint8_t count) { return count > 0; });
 }
 
 /**
- * @brief Prompts the player to select a powerup from their inventory and returns the selected powerup
- * @return The selected powerup or std::nullopt if the user cancels
- * @note If the player has no powerups, a message is displayed and std::nullopt is returned
+ * @brief Gets the player's pieces
+ * @return A view of the pieces, in no particular order
  */
-std::optional<Powerup> Player::selectPowerup() const {
-    if (!hasPowerups()) {
-        std::cout << "You have no powerups!" << std::endl;
-        return std::nullopt;
-    }
-    std::ostringstream prompt;
-    prompt << "Which powerup would you like to use?";
-    for (std::size_t i = 0; i < inventory.size(); ++i) {
-        prompt << std::format("\n{}) {}", i + 1, powerupToString(inventory.at(i)));
-    }
-    const auto exitNum = static_cast<int>(inventory.size()) + 1;
-    prompt << "\n"
-           << exitNum << ") Cancel";
-    const int choice = getValidInt(prompt.str(), 1, exitNum);
-    if (choice == exitNum) {
-        return std::nullopt;
-    }
-    return inventory.at(choice - 1);
+std::span<const Piece> Player::getPieces() const {
+    return {pieces.data(), static_cast<std::size_t>(numPieces)};
 }
 
 /**
- * @brief Prompts the player to select a dot to move and returns the dot's coordinate
- * @return The coordinate of the selected dot or std::nullopt if the user cancels
+ * @brief Gets the piece at a coordinate
+ * @param coord The coordinate to look at
+ * @return A pointer to the piece, or nullptr if the player has no piece there
  */
-std::optional<Piece> Player::selectPiece() const {
-    std::ostringstream prompt;
-    prompt << "Which piece would you like to move?";
-    int count = 1;
-    for (const auto &piece : pieces) {
-        prompt << std::format("\n{}) {}", count++, coordToString(piece.coord));
-    }
-    const int exitNum = count;
-    prompt << std::format("\n{}) Cancel", exitNum);
-    const int selected = getValidInt(prompt.str(), 1, exitNum);
-    if (selected == exitNum) {
-        return std::nullopt;
-    }
-    // skip to the selected element and return its coordinate
-    return std::make_optional(*std::next(pieces.begin(), selected - 1));
+const Piece *Player::getPiece(const std::pair<int, int> &coord) const {
+    const std::uint8_t index = pieceIndex[coord.first][coord.second];
+    return index == NO_PIECE ? nullptr : &pieces[index];
 }
 
 /**
@@ -111,43 +119,18 @@ std::optional<Piece> Player::selectPiece() const {
 std::optional<std::pair<int, int>> Player::getDestination(const Board &board,
                                                           const std::pair<int, int> &origin,
                                                           const std::pair<int, int> &vector) const {
-    const std::pair<int, int> newPos = vectorAddition(origin, vector);
+    // Blank cells are slid over using the board's precomputed stopping squares
+    const std::optional<std::pair<int, int>> newPos = board.slide(origin, vector);
     // If the new position is off the board, return std::nullopt
-    if (!board.isWithinBounds(newPos)) {
+    if (!newPos.has_value()) {
         return std::nullopt;
     }
-    const std::set<Cell> forbiddenCells = {BARRIER_CELL, cell, bishopCell};
-    // If the new position is not one of the allowed characters, return std::nullopt
-    if (const Cell destinationCell = board.getCell(newPos); forbiddenCells.contains(destinationCell)) {
-        return std::nullopt;
-        // If the new position is a blank space, calculate the move again in the same direction, effectively hopping over the space
-    } else if (destinationCell == BLANK_CELL) {
-        return getDestination(board, newPos, vector);
-    }
-    return newPos;  // have to convert to optional to agree with return type
-}
-
-/**
- * @brief Prompts the user to select a destination for the dot and returns the destination
- * @param moves The possible moves for the dot
- * @return The vector of the selected direction or std::nullopt if the user cancels
- */
-std::optional<std::pair<int, int>> Player::selectDestination(const std::map<DirectionData, std::pair<int, int>> &moves) const {
-    std::ostringstream prompt;
-    prompt << "Where would you like to move the dot?";
-    std::set<char> accepted = {'C', 'c'};
-    for (const auto &[move, _] : moves) {
-        prompt << std::format("\n{}) {}", move.key, move.name);
-        accepted.insert(move.key);
-        accepted.emplace(static_cast<char>(std::tolower(move.key)));
-    }
-    prompt << "\nC) Cancel";
-    // convert input to upper case character
-    const auto wasd = static_cast<char>(std::toupper(getValidString(prompt.str(), 1, 1, "C", std::make_optional(accepted)).value()[0]));
-    if (wasd == 'C') {
+    // If the new position is not one of the allowed cells, return std::nullopt
+    if (const Cell &destinationCell = board.getCell(newPos.value());
+        destinationCell == BARRIER_CELL || destinationCell == cell || destinationCell == bishopCell) {
         return std::nullopt;
     }
-    return std::ranges::find_if(moves, [&wasd](const auto &move) { return move.first.key == wasd; })->second;
+    return newPos;
 }
 
 /**
@@ -160,47 +143,25 @@ std::optional<std::pair<int, int>> Player::selectDestination(const std::map<Dire
 std::map<DirectionData, std::pair<int, int>> Player::detectMoves(const Board &board, const Piece &piece, const bool isHop) const {
     std::map<DirectionData, std::pair<int, int>> moves;
     for (const auto &direction : piece.getDirections(isHop)) {
-        if (const auto destination = getDestination(board, piece.coord, direction.vector); destination.has_value()) {
-            // try_emplace will only insert the element if the key does not already exist
+        if (const auto destination = getDestination(board, piece.coord(), direction.vector); destination.has_value()) {
             moves[direction] = destination.value();
         }
     }
     return moves;
 }
 
-/**
- * @brief Attempts to perform a move by the user
- * @param vectors The vectors to move in
- * @return a pair of the origin and destination of the move or std::nullopt if the user cancels
- */
-std::optional<std::pair<std::pair<int, int>, std::pair<int, int>>> Player::attemptMove(const Board &board, const bool isHop) const {
-    std::map<DirectionData, std::pair<int, int>> moves;
-    std::optional<Piece> selectedPiece;
-    while (true) {
-        selectedPiece = selectPiece();
-        if (!selectedPiece.has_value()) {  // check if user cancelled piece selection
-            return std::nullopt;
-        }
-        moves = detectMoves(board, selectedPiece.value(), isHop);
-        if (moves.empty()) {
-            std::cout << "This dot cannot move." << std::endl;
-            continue;
-        }
-        break;
-    }
-    const std::optional<std::pair<int, int>> destination = selectDestination(moves);
-    if (!destination.has_value()) {  // check if user cancelled destination selection
-        return std::nullopt;
-    }
-    return std::make_pair(selectedPiece.value().coord, destination.value());
-}
-
 /**
  * @brief Adds a piece to the player's pieces
  * @param piece The piece to add
+ * @throws std::length_error if the player already has MAX_PIECES pieces
  */
 void Player::addPiece(const Piece &piece) {
-    pieces.insert(piece);
+    if (numPieces == MAX_PIECES) {
+        throw std::length_error(std::format("A player cannot have more than {} pieces", MAX_PIECES));
+    }
+    pieces[numPieces] = piece;
+    pieceIndex[piece.row][piece.column] = static_cast<std::uint8_t>(numPieces);
+    numPieces++;
 }
 
 /**
@@ -208,24 +169,25 @@ void Player::addPiece(const Piece &piece) {
  * @param piece The piece to remove
  */
 void Player::removePiece(const Piece &piece) {
-    pieces.erase(piece);
+    removePiece(piece.coord());
 }
 
 /**
  * @brief Removes a piece from the player's pieces
  * @param coord The coordinate of the piece to remove
+ * @note The last piece is moved into the freed slot to keep the pieces dense
  */
 void Player::removePiece(const std::pair<int, int> &coord) {
-    pieces.erase(std::ranges::find_if(pieces, [&coord](const Piece &piece) { return piece.coord == coord; }));
-}
-
-/**
- * @brief Updates the position of a piece
- * @param piece The piece to update
- * @param newCoord The new coordinate of the piece
- */
-void Player::updatePiece(Piece &piece, const std::pair<int, int> &newCoord) {
-    piece.coord = newCoord;
+    const std::uint8_t index = pieceIndex[coord.first][coord.second];
+    if (index == NO_PIECE) {
+        return;
+    }
+    pieceIndex[coord.first][coord.second] = NO_PIECE;
+    numPieces--;
+    if (index != numPieces) {
+        pieces[index] = pieces[numPieces];
+        pieceIndex[pieces[index].row][pieces[index].column] = index;
+    }
 }
 
 /**
@@ -234,32 +196,40 @@ void Player::updatePiece(Piece &piece, const std::pair<int, int> &newCoord) {
  * @param newCoord The new coordinate of the piece
  * @throws std::invalid_argument if no piece is found at the given coordinate
  */
-void Player::updatePiece(const std::pair<int, int> &coord, std::pair<int, int> &newCoord) {
-    auto matchingPiece = std::ranges::find_if(pieces, [&coord](const Piece &piece) { return piece.coord == coord; });
-    if (matchingPiece == pieces.end()) {
+void Player::updatePiece(const std::pair<int, int> &coord, const std::pair<int, int> &newCoord) {
+    const std::uint8_t index = pieceIndex[coord.first][coord.second];
+    if (index == NO_PIECE) {
         throw std::invalid_argument(std::format("No piece found at the given coordinate: {}", coordToString(coord)));
     }
-    // We cannot edit elements of a set directly, so we must remove the original piece and insert an updated copy
-    Piece updatedPiece = *matchingPiece;
-    // Remove the original piece from the set
-    pieces.erase(matchingPiece);
-    updatedPiece.coord = newCoord;
-    // Reinsert the updated piece into the set
-    pieces.insert(updatedPiece);
+    pieceIndex[coord.first][coord.second] = NO_PIECE;
+    pieces[index].updatePosition(newCoord);
+    pieceIndex[newCoord.first][newCoord.second] = index;
 }
 
 /**
  * @brief Upgrades a piece to a bishop
  * @param piece The piece to upgrade
+ * @return False if the player has no piece there or it is already a bishop
  */
 bool Player::upgradePiece(const Piece &piece) {
-    Piece upgradedPiece = piece;
-    if (upgradedPiece.isBishop) {
-        std::cout << "This piece is already a bishop!" << std::endl;
+    const std::uint8_t index = pieceIndex[piece.row][piece.column];
+    if (index == NO_PIECE) {
         return false;
     }
-    upgradedPiece.bishopUpgrade(bishopCell);
-    pieces.erase(piece);
-    pieces.insert(upgradedPiece);
+    if (pieces[index].isBishop) {
+        return false;
+    }
+    pieces[index].bishopUpgrade(bishopCell);
     return true;
 }
+
+/**
+ * @brief Reverts a bishop back to a regular piece
+ * @param coord The coordinate of the bishop
+ */
+void Player::downgradePiece(const std::pair<int, int> &coord) {
+    if (const std::uint8_t index = pieceIndex[coord.first][coord.second]; index != NO_PIECE) {
+        pieces[index].isBishop = false;
+        pieces[index].cell = cell;
+    }
+}
@@ -0,0 +1,449 @@
+#include "proof_search.h"
+
+#include <algorithm>  // std::min, std::max, std::find
+#include <bit>        // std::bit_floor
+#include <chrono>
+#include <format>  // std::format
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <utility>  // std::make_pair
+
+#include "game.h"
+#include "move_generator.h"
+#include "other_tools.h"
+#include "settings_data.h"
+#include "tablebase.h"
+
+// Extra delta given to a child for each other thread searching below it, when choosing a child
+const std::uint32_t BUSY_PENALTY = 4;
+
+// A child is searched until its delta passes the second best child's by this fraction (the 1 + epsilon
+// trick), so the search switches between siblings and expands the same positions again less often
+const std::uint32_t EPSILON_DIVISOR = 4;
+
+// Nodes a worker counts before adding them to the shared total
+const std::uint64_t PROOF_NODE_BATCH = 1024;
+
+/**
+ * @brief Adds proof numbers, saturating below PROOF_INFINITY so an unsolved sum never looks solved
+ */
+std::uint32_t addProofNumbers(const std::uint32_t a, const std::uint32_t b) {
+    if (a == PROOF_INFINITY || b == PROOF_INFINITY) {
+        return PROOF_INFINITY;
+    }
+    return static_cast<std::uint32_t>(std::min<std::uint64_t>(std::uint64_t{a} + b, PROOF_INFINITY - 1));
+}
+
+/**
+ * @brief Gets the key of a position in the proof table
+ * @return The smaller hash of the position and its reflection. Game::canonicalKey also tries the
+ * colour swapping symmetries, which would share the numbers of positions with the attacker and the
+ * defender swapped
+ */
+std::uint64_t proofKey(const Game &game) {
+    return std::min(game.symmetricHash(Symmetry::IDENTITY), game.symmetricHash(Symmetry::REFLECTION));
+}
+
+/**
+ * @brief Construct a new Proof Table object
+ * @param megabytes The size of the table in MB, rounded down to a power of two number of clusters
+ * @throws std::bad_alloc if the memory cannot be allocated
+ */
+ProofTable::ProofTable(const std::size_t megabytes)
+    : numClusters(std::bit_floor(std::max<std::size_t>(megabytes * 1024 * 1024 / sizeof(ProofCluster), 1))) {
+    clusters = std::make_unique<ProofCluster[]>(numClusters);
+}
+
+/**
+ * @brief Empties every slot
+ * @note Must not be called while any thread is searching
+ */
+void ProofTable::clear() {
+    for (std::size_t i = 0; i < numClusters; i++) {
+        clusters[i].slots.fill({});
+    }
+}
+
+/**
+ * @brief A spin lock held on a cluster for the lifetime of the guard
+ */
+struct ClusterGuard {
+    ProofCluster &cluster;
+
+    explicit ClusterGuard(ProofCluster &cluster) : cluster(cluster) {
+        while (cluster.lock.test_and_set(std::memory_order_acquire)) {
+            cluster.lock.wait(true, std::memory_order_relaxed);
+        }
+    }
+
+    ~ClusterGuard() {
+        cluster.lock.clear(std::memory_order_release);
+        cluster.lock.notify_one();
+    }
+};
+
+/**
+ * @brief Finds the slot of a position, replacing the slot with the least work if it has none
+ * @note The cluster must be locked. Slots with threads searching below them are only replaced if
+ * every slot has some
+ */
+ProofSlot &ProofTable::findSlot(ProofCluster &cluster, const std::uint64_t hash) {
+    ProofSlot *replace = &cluster.slots[0];
+    for (ProofSlot &slot : cluster.slots) {
+        if (slot.key == hash) {
+            return slot;
+        }
+        if (std::make_pair(slot.searchers > 0, slot.work) < std::make_pair(replace->searchers > 0, replace->work)) {
+            replace = &slot;
+        }
+    }
+    *replace = {hash, {}, 0, 0};
+    return *replace;
+}
+
+/**
+ * @brief Looks up the proof numbers of a position
+ * @param hash The hash of the position
+ * @param searchers Set to the number of threads searching below the position, if not nullptr
+ * @return The stored numbers, or 1 and 1 if the position is not in the table
+ */
+ProofNumbers ProofTable::probe(const std::uint64_t hash, std::uint16_t *searchers) {
+    ProofCluster &found = cluster(hash);
+    const ClusterGuard guard(found);
+    for (const ProofSlot &slot : found.slots) {
+        if (slot.key == hash) {
+            if (searchers != nullptr) {
+                *searchers = slot.searchers;
+            }
+            return slot.numbers;
+        }
+    }
+    if (searchers != nullptr) {
+        *searchers = 0;
+    }
+    return {};
+}
+
+/**
+ * @brief Stores the proof numbers of a position
+ * @param hash The hash of the position
+ * @param numbers The numbers to store
+ * @param work The nodes searched to find the numbers
+ */
+void ProofTable::store(const std::uint64_t hash, const ProofNumbers &numbers, const std::uint64_t work) {
+    ProofCluster &found = cluster(hash);
+    const ClusterGuard guard(found);
+    ProofSlot &slot = findSlot(found, hash);
+    slot.numbers = numbers;
+    slot.work = static_cast<std::uint32_t>(std::min<std::uint64_t>(std::uint64_t{slot.work} + work, UINT32_MAX));
+}
+
+/**
+ * @brief Marks that a thread has started searching below a position
+ */
+void ProofTable::enter(const std::uint64_t hash) {
+    ProofCluster &found = cluster(hash);
+    const ClusterGuard guard(found);
+    findSlot(found, hash).searchers++;
+}
+
+/**
+ * @brief Marks that a thread has finished searching below a position
+ * @note Nothing is done if the position was replaced in the meantime
+ */
+void ProofTable::leave(const std::uint64_t hash) {
+    ProofCluster &found = cluster(hash);
+    const ClusterGuard guard(found);
+    for (ProofSlot &slot : found.slots) {
+        if (slot.key == hash && slot.searchers > 0) {
+            slot.searchers--;
+        }
+    }
+}
+
+/**
+ * @brief State shared by every worker of one proof search
+ */
+struct SharedProofState {
+    const int attacker;
+    const std::uint64_t maxNodes;
+    std::atomic<std::uint64_t> nodes{0};
+    std::atomic<bool> stopped{false};  // Set once the root is solved or the node limit is reached
+};
+
+/**
+ * @brief A child of a position being searched
+ */
+struct ProofChild {
+    std::uint64_t hash;
+    std::optional<ProofNumbers> fixed;  // The numbers of a child that is never searched
+};
+
+/**
+ * @brief One worker of a proof search, with its own copy of the game
+ */
+struct ProofWorker {
+    Game game;
+    ProofTable &table;
+    const TablebaseSet &tablebases;
+    SharedProofState &shared;
+    std::vector<std::unique_ptr<ActionList>> actionLists;  // Actions of each ply, reused between nodes
+    std::vector<std::vector<ProofChild>> children;         // Children of each ply, reused between nodes
+    std::vector<std::uint64_t> path;                       // Proof table keys of the positions from the root
+    std::uint64_t nodes = 0;
+
+    /**
+     * @brief Counts a node, adding the count to the shared total in batches
+     */
+    void countNode() {
+        nodes++;
+        if (nodes % PROOF_NODE_BATCH == 0 &&
+            shared.nodes.fetch_add(PROOF_NODE_BATCH, std::memory_order_relaxed) + PROOF_NODE_BATCH >= shared.maxNodes) {
+            shared.stopped.store(true, std::memory_order_relaxed);
+        }
+    }
+
+    /**
+     * @brief Gets the numbers of the attacker failing, from the point of view of the player to move
+     */
+    ProofNumbers attackerFails() const {
+        return game.currentPlayerID == shared.attacker ? ProofNumbers{PROOF_INFINITY, 0} : ProofNumbers{0, PROOF_INFINITY};
+    }
+
+    /**
+     * @brief Gets the numbers of a position whose outcome is known without searching it
+     * @param hash The hash of the position
+     * @param ply The ply of the position
+     * @return The numbers, or std::nullopt if the position must be searched
+     */
+    std::optional<ProofNumbers> fixedNumbers(const std::uint64_t hash, const int ply) const {
+        if (game.getAllyPlayer().numPieces == 0) {
+            return ProofNumbers{PROOF_INFINITY, 0};
+        }
+        if (ply >= MAX_PROOF_PLY || std::find(path.begin(), path.end(), hash) != path.end()) {
+            return attackerFails();
+        }
+        if (const std::optional<TablebaseEntry> solved = tablebases.probe(game); solved.has_value()) {
+            switch (solved->result) {
+                case TablebaseResult::WIN:
+                    return ProofNumbers{0, PROOF_INFINITY};
+                case TablebaseResult::LOSS:
+                    return ProofNumbers{PROOF_INFINITY, 0};
+                default:
+                    return attackerFails();
+            }
+        }
+        return std::nullopt;
+    }
+
+    /**
+     * @brief Lists the children of the current position
+     * @param ply The ply of the current position
+     * @return The children, empty if the player to move has no actions
+     */
+    std::vector<ProofChild> &listChildren(const int ply) {
+        if (static_cast<std::size_t>(ply) >= actionLists.size()) {
+            actionLists.push_back(std::make_unique<ActionList>());
+            children.emplace_back();
+        }
+        ActionList &actions = *actionLists[ply];
+        std::vector<ProofChild> &list = children[ply];
+        generateActions(game, actions);
+        list.clear();
+        for (const Action &action : actions) {
+            game.makeMove(action);
+            const std::uint64_t hash = proofKey(game);
+            list.push_back({hash, fixedNumbers(hash, ply + 1)});
+            game.unmakeMove();
+        }
+        return list;
+    }
+
+    /**
+     * @brief Searches the current position until its numbers reach a threshold or the search stops
+     * @param hash The hash of the current position, which must not have fixed numbers
+     * @param thresholdPhi The phi at which to return
+     * @param thresholdDelta The delta at which to return
+     * @param ply The ply of the current position
+     */
+    void search(const std::uint64_t hash, const std::uint32_t thresholdPhi, const std::uint32_t thresholdDelta, const int ply) {
+        countNode();
+        const std::uint64_t startNodes = nodes;
+        std::vector<ProofChild> &list = listChildren(ply);
+        if (list.empty()) {
+            table.store(hash, {PROOF_INFINITY, 0}, 1);
+            return;
+        }
+        table.enter(hash);
+        path.push_back(hash);
+        while (true) {
+            // phi is the smallest delta of a child and delta the sum of the children's phis
+            ProofNumbers numbers{PROOF_INFINITY, 0};
+            std::size_t best = 0;
+            std::uint32_t bestDelta = PROOF_INFINITY;    // Including the busy penalty
+            std::uint32_t secondDelta = PROOF_INFINITY;  // Including the busy penalty
+            ProofNumbers bestNumbers;
+            for (std::size_t i = 0; i < list.size(); i++) {
+                std::uint16_t searchers = 0;
+                const ProofNumbers child = list[i].fixed.has_value() ? list[i].fixed.value() : table.probe(list[i].hash, &searchers);
+                numbers.phi = std::min(numbers.phi, child.delta);
+                numbers.delta = addProofNumbers(numbers.delta, child.phi);
+                // The penalty stays below the threshold, so the chosen child can always be searched
+                std::uint32_t delta = child.delta;
+                if (searchers > 0 && !child.isSolved()) {
+                    delta = std::max(child.delta, std::min(addProofNumbers(child.delta, searchers * BUSY_PENALTY), thresholdPhi - 1));
+                }
+                if (delta < bestDelta) {
+                    secondDelta = bestDelta;
+                    bestDelta = delta;
+                    bestNumbers = child;
+                    best = i;
+                } else if (delta < secondDelta) {
+                    secondDelta = delta;
+                }
+            }
+            if (numbers.phi >= thresholdPhi || numbers.delta >= thresholdDelta || numbers.isSolved() ||
+                shared.stopped.load(std::memory_order_relaxed)) {
+                table.store(hash, numbers, nodes - startNodes + 1);
+                break;
+            }
+            // The child is searched until the position's delta would reach its threshold or another child would become the best
+            const std::uint32_t childPhi = static_cast<std::uint32_t>(
+                std::min<std::uint64_t>(std::uint64_t{thresholdDelta} - numbers.delta + bestNumbers.phi, PROOF_INFINITY));
+            const std::uint32_t childDelta = std::min(thresholdPhi, addProofNumbers(secondDelta, secondDelta / EPSILON_DIVISOR + 1));
+            game.makeMove((*actionLists[ply])[best]);
+            search(list[best].hash, childPhi, childDelta, ply + 1);
+            game.unmakeMove();
+        }
+        path.pop_back();
+        table.leave(hash);
+    }
+};
+
+/**
+ * @brief Construct a new Proof Searcher object
+ * @param scheduler The scheduler whose workers search
+ * @param table The proof table every worker shares
+ */
+ProofSearcher::ProofSearcher(TaskScheduler &scheduler, ProofTable &table)
+    : scheduler(scheduler), table(table), tablebases(getTablebases()) {}
+
+/**
+ * @brief Searches whether a player can force a win from a position
+ * @param game The game to solve, which must not place powerups
+ * @param attacker The ID of the player trying to win
+ * @param maxNodes The number of nodes to visit before giving up
+ * @return The result, with the winning action if the attacker is to move and wins
+ * @throws std::invalid_argument if the game places powerups
+ * @note Must be called from the thread that owns the scheduler. The table should be cleared before
+ * solving for a different attacker
+ */
+ProofSearchResult ProofSearcher::solve(const Game &game, const int attacker, const std::uint64_t maxNodes) {
+    if (game.placesPowerups()) {
+        throw std::invalid_argument("Only games without powerup placement can be solved");
+    }
+    const auto start = std::chrono::steady_clock::now();
+    SharedProofState shared{attacker, maxNodes};
+    std::vector<std::unique_ptr<ProofWorker>> workers;
+    for (int i = 0; i < scheduler.size(); i++) {
+        workers.push_back(std::make_unique<ProofWorker>(ProofWorker{game, table, tablebases, shared, {}, {}, {}, 0}));
+        // Lines run MAX_PROOF_PLY actions past the root's history, so making them never allocates
+        workers.back()->game.history.reserve(game.history.size() + MAX_PROOF_PLY);
+        // Reserved so the lists of a ply never move while deeper plies are searched
+        workers.back()->actionLists.reserve(MAX_PROOF_PLY);
+        workers.back()->children.reserve(MAX_PROOF_PLY);
+    }
+    ProofWorker &root = *workers[0];
+    const std::uint64_t rootHash = proofKey(game);
+    ProofNumbers numbers;
+    if (const std::optional<ProofNumbers> fixed = root.fixedNumbers(rootHash, 0); fixed.has_value()) {
+        numbers = fixed.value();
+    } else {
+        TaskGroup group;
+        for (int i = 0; i < scheduler.size(); i++) {
+            scheduler.spawn(group, [&workers, &shared, rootHash](Worker &worker) {
+                ProofWorker &proofWorker = *workers[worker.index];
+                if (!shared.stopped.load(std::memory_order_relaxed)) {
+                    proofWorker.search(rootHash, PROOF_INFINITY, PROOF_INFINITY, 0);
+                    shared.stopped.store(true, std::memory_order_relaxed);
+                }
+            });
+        }
+        scheduler.wait(group);
+        numbers = table.probe(rootHash);
+    }
+
+    ProofSearchResult result;
+    for (const auto &worker : workers) {
+        result.nodes += worker->nodes;
+    }
+    result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    if (!numbers.isSolved()) {
+        return result;
+    }
+    const bool moverWins = numbers.phi == 0;
+    result.result = moverWins == (game.currentPlayerID == attacker) ? ProofResult::PROVEN : ProofResult::DISPROVEN;
+    if (result.result == ProofResult::PROVEN && game.currentPlayerID == attacker) {
+        // A winning action leads to a position the defender loses
+        const std::vector<ProofChild> &children = root.listChildren(0);
+        for (std::size_t i = 0; i < children.size(); i++) {
+            const ProofNumbers child = children[i].fixed.has_value() ? children[i].fixed.value() : table.probe(children[i].hash);
+            if (child.delta == 0) {
+                result.winningAction = (*root.actionLists[0])[i];
+                break;
+            }
+        }
+    }
+    return result;
+}
+
+/**
+ * @brief Solves the starting position of a map with powerup placement turned off and reports the result
+ * @param map The map to solve, with the other settings at their defaults
+ * @param maxNodes The number of nodes to visit for each player before giving up
+ * @param threads The number of threads to search with
+ * @param megabytes The size of the proof table in MB
+ * @param out The stream the result is reported to
+ * @throws std::invalid_argument if the map is generated at random
+ * @note Player 1 is tried as the attacker first, then player 2 if player 1 has no forced win
+ */
+void solveMap(const Map &map, const std::uint64_t maxNodes, const int threads, const std::size_t megabytes, std::ostream &out) {
+    if (map == Map::RANDOM) {
+        throw std::invalid_argument("Only fixed maps can be solved");
+    }
+    SettingsData settings;
+    settings.map = map;
+    settings.powerupPlacementFrequency = 0;
+    const Game game(settings);
+
+    ProofTable table(megabytes);
+    TaskScheduler scheduler(threads, 0);
+    ProofSearcher searcher(scheduler, table);
+    out << std::format("Solving {} without powerup placement on {} threads, up to {} nodes per player",
+                       mapToString(map), threads, maxNodes)
+        << std::endl;
+    bool unknown = false;
+    for (const int attacker : {1, 2}) {
+        table.clear();
+        const ProofSearchResult result = searcher.solve(game, attacker, maxNodes);
+        const double nodesPerSecond = result.seconds > 0.0 ? result.nodes / result.seconds : 0.0;
+        const std::string statistics = std::format("{} nodes in {:.2f}s, {:.0f} nodes/s", result.nodes, result.seconds, nodesPerSecond);
+        if (result.result == ProofResult::PROVEN) {
+            out << std::format("Proof: player {} wins by force ({})", attacker, statistics) << std::endl;
+            if (result.winningAction.has_value()) {
+                out << "Winning first action: " << game.describeAction(result.winningAction.value()) << std::endl;
+            }
+            return;
+        }
+        if (result.result == ProofResult::DISPROVEN) {
+            out << std::format("Disproof: player {} has no forced win ({})", attacker, statistics) << std::endl;
+        } else {
+            out << std::format("Player {} unresolved after the node limit ({})", attacker, statistics) << std::endl;
+            unknown = true;
+        }
+    }
+    if (!unknown) {
+        out << "Neither player was found to force a win. Repetitions count as failing to win, so this is not a proof of a draw" << std::endl;
+    }
+}
@@ -1,41 +1,127 @@
 #include "random.h"
 
-// Define the static member variable
-Random Random::instance;
+#include <random>  // std::random_device
+
+#include "split_mix.h"
+
+// Define the static member variable, each thread gets its own seeded generator
+thread_local Random Random::instance;
+
+std::atomic<bool> Random::isSeedFixed{false};
+std::atomic<std::uint64_t> Random::fixedSeed{0};
+std::atomic<std::uint64_t> Random::fixedStreams{0};
+
+/**
+ * @brief Fills the state from a seed
+ * @param value The seed, any value including 0 gives a valid state
+ */
+void Xoshiro256::seed(std::uint64_t value) {
+    for (std::uint64_t &word : state) {
+        word = splitMix64(value);
+    }
+}
 
 /**
  * @brief Construct a new Random::Random object
- * Initialize the random number generator with a seed
- * The seed is generated using std::random_device
+ * Initialize the random number generator with a seed from freshSeed
  */
-Random::Random() : generator(std::random_device{}()) {}
+Random::Random() {
+    generator.seed(freshSeed());
+}
 
 /**
- * @brief Get the singleton instance
- * @return The singleton instance
+ * @brief Construct a new Random::Random object with a chosen seed
+ * @param value The seed
+ */
+Random::Random(const std::uint64_t value) {
+    generator.seed(value);
+}
+
+/**
+ * @brief Get the calling thread's instance
+ * @return The calling thread's instance
  */
 Random& Random::getInstance() {
     return instance;
 }
 
+/**
+ * @brief Reseeds the generator, so a sequence of random numbers can be reproduced
+ * @param value The new seed
+ */
+void Random::seed(const std::uint64_t value) {
+    generator.seed(value);
+}
+
 /**
  * @brief Get a random integer
  * @param min The minimum value
  * @param max The maximum value
- * @return A random integer
+ * @return A random integer, every value in the range equally likely
+ * @note Uses Lemire's multiply-and-shift method, which only draws again for the few values that would bias the result
  */
 int Random::getInt(int min, int max) {
-    std::uniform_int_distribution dist(min, max);
-    return dist(generator);
+    const std::uint32_t range = static_cast<std::uint32_t>(max) - static_cast<std::uint32_t>(min) + 1;
+    auto bits = static_cast<std::uint32_t>(generator() >> 32);
+    if (range == 0) {  // the whole range of int
+        return static_cast<int>(bits);
+    }
+    std::uint64_t product = static_cast<std::uint64_t>(bits) * range;
+    if (static_cast<std::uint32_t>(product) < range) {
+        const std::uint32_t threshold = -range % range;
+        while (static_cast<std::uint32_t>(product) < threshold) {
+            bits = static_cast<std::uint32_t>(generator() >> 32);
+            product = static_cast<std::uint64_t>(bits) * range;
+        }
+    }
+    return static_cast<int>(static_cast<std::uint32_t>(min) + static_cast<std::uint32_t>(product >> 32));
 }
 
 /**
  * @brief Get a random float
  * @param min The minimum value
- * @param max The maximum value
+ * @param max The maximum value, never returned
  * @return A random float
  */
 float Random::getFloat(float min, float max) {
-    std::uniform_real_distribution dist(min, max);
-    return dist(generator);
+    // the top 24 bits fill a float's mantissa exactly
+    const float unit = static_cast<float>(generator() >> 40) * 0x1.0p-24f;
+    return min + (max - min) * unit;
+}
+
+/**
+ * @brief Turns on the fixed seed mode, making every generator seeded afterwards reproducible
+ * @param value The fixed seed
+ * @note Reseeds the calling thread's generator with the seed itself. Generators created afterwards,
+ * including those of new threads, and freshSeed take derived seeds in the order they ask for them
+ */
+void Random::setFixedSeed(const std::uint64_t value) {
+    fixedSeed.store(value);
+    fixedStreams.store(0);
+    isSeedFixed.store(true);
+    getInstance().seed(value);
+}
+
+/**
+ * @brief Gets a seed for a new generator or scheduler
+ * @return A seed from std::random_device, or the next seed derived from the fixed seed if one is set
+ */
+std::uint64_t Random::freshSeed() {
+    if (isSeedFixed.load()) {
+        return deriveSeed(fixedSeed.load(), fixedStreams.fetch_add(1));
+    }
+    std::random_device device;
+    return static_cast<std::uint64_t>(device()) << 32 | device();
+}
+
+/**
+ * @brief Derives the seed of one stream, such as one game of many, from a base seed
+ * @param seed The base seed
+ * @param stream The number of the stream
+ * @return The stream's seed, unrelated to the seeds of neighbouring streams
+ */
+std::uint64_t Random::deriveSeed(const std::uint64_t seed, const std::uint64_t stream) {
+    std::uint64_t streamState = stream;
+    std::uint64_t state = seed ^ splitMix64(streamState);
+    return splitMix64(state);
 }
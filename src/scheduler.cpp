@@ -0,0 +1,140 @@
+#include "scheduler.h"
+
+#include <algorithm>  // std::max
+#include <optional>
+#include <utility>    // std::move
+
+// Index of the worker running on this thread, threads the scheduler did not start count as worker 0
+thread_local int currentWorkerIndex = 0;
+
+/**
+ * @brief Construct a new Task Scheduler object and start its worker threads
+ * @param numWorkers The number of workers, including the calling thread
+ * @param seed The seed the workers' generators are derived from, so runs can be reproduced
+ */
+TaskScheduler::TaskScheduler(const int numWorkers, const std::uint32_t seed) : ownerRandom(seed) {
+    const int count = std::max(numWorkers, 1);
+    for (int i = 0; i < count; i++) {
+        queues.push_back(std::make_unique<WorkerQueue>());
+    }
+    for (int i = 1; i < count; i++) {
+        threads.emplace_back(&TaskScheduler::workerLoop, this, i, seed);
+    }
+}
+
+/**
+ * @brief Destroy the Task Scheduler object, after its workers finish their queued tasks
+ */
+TaskScheduler::~TaskScheduler() {
+    shuttingDown.store(true);
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+    }
+    wakeUp.notify_all();
+    for (std::thread &thread : threads) {
+        thread.join();
+    }
+}
+
+/**
+ * @brief Gets the number of workers, including the owning thread
+ */
+int TaskScheduler::size() const {
+    return static_cast<int>(queues.size());
+}
+
+/**
+ * @brief Queues a task on the calling worker's deque
+ * @param group The group the task belongs to
+ * @param task The task to run, which must not throw
+ */
+void TaskScheduler::spawn(TaskGroup &group, Task task) {
+    group.pending.fetch_add(1, std::memory_order_relaxed);
+    {
+        WorkerQueue &queue = *queues[currentWorkerIndex];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        queue.tasks.push_back({std::move(task), &group});
+    }
+    queuedTasks.fetch_add(1);
+    {
+        // Taking the lock orders this wake up after a sleeping worker's last check of queuedTasks
+        std::lock_guard<std::mutex> lock(sleepMutex);
+    }
+    wakeUp.notify_one();
+}
+
+/**
+ * @brief Runs tasks until every task of a group has finished
+ * @param group The group to wait for
+ * @note The calling thread runs its own tasks and steals others' rather than blocking. The owning
+ * thread runs them with the scheduler's worker 0 generator, seeded with the scheduler's seed
+ */
+void TaskScheduler::wait(TaskGroup &group) {
+    Worker worker{currentWorkerIndex, currentWorkerIndex == 0 ? ownerRandom : Random::getInstance()};
+    while (!group.done()) {
+        if (!runOne(worker)) {
+            std::this_thread::yield();  // the group's last tasks are running on other workers
+        }
+    }
+}
+
+/**
+ * @brief Runs one task, from the worker's own deque if it has one, otherwise stolen from another worker
+ * @param worker The worker to run the task on
+ * @return True if a task was run, false if every deque was empty
+ */
+bool TaskScheduler::runOne(Worker &worker) {
+    std::optional<Entry> entry;
+    {
+        WorkerQueue &own = *queues[worker.index];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        if (!own.tasks.empty()) {
+            entry = std::move(own.tasks.back());
+            own.tasks.pop_back();
+        }
+    }
+    // Start stealing from a random victim so thieves do not all contend for the same deque
+    const int numQueues = size();
+    const int firstVictim = !entry.has_value() && numQueues > 1 ? worker.random.getInt(0, numQueues - 1) : 0;
+    for (int i = 0; i < numQueues && !entry.has_value(); i++) {
+        const int victim = (firstVictim + i) % numQueues;
+        if (victim == worker.index) {
+            continue;
+        }
+        WorkerQueue &queue = *queues[victim];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (!queue.tasks.empty()) {
+            entry = std::move(queue.tasks.front());
+            queue.tasks.pop_front();
+        }
+    }
+    if (!entry.has_value()) {
+        return false;
+    }
+    queuedTasks.fetch_sub(1);
+    entry->task(worker);
+    entry->group->pending.fetch_sub(1, std::memory_order_release);
+    return true;
+}
+
+/**
+ * @brief Runs tasks on a worker thread, sleeping while there are none, until the scheduler shuts down
+ * @param index The index of the worker
+ * @param seed The scheduler's seed, the worker's generator is seeded with it plus its index
+ */
+void TaskScheduler::workerLoop(const int index, const std::uint32_t seed) {
+    currentWorkerIndex = index;
+    Random &random = Random::getInstance();
+    random.seed(seed + static_cast<std::uint32_t>(index));
+    Worker worker{index, random};
+    while (true) {
+        if (runOne(worker)) {
+            continue;
+        }
+        std::unique_lock<std::mutex> lock(sleepMutex);
+        wakeUp.wait(lock, [this]() { return queuedTasks.load() > 0 || shuttingDown.load(); });
+        if (shuttingDown.load() && queuedTasks.load() == 0) {
+            return;
+        }
+    }
+}
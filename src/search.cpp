@@ -0,0 +1,554 @@
+#include "search.h"
+
+#include <algorithm>  // std::any_of, std::find, std::min, std::stable_sort, std::swap
+#include <array>
+#include <chrono>
+#include <utility>  // std::pair
+
+#include "cell.h"
+#include "enums.h"
+#include "evaluation.h"
+#include "game.h"
+#include "move_generator.h"
+#include "tablebase.h"
+#include "transposition_table.h"
+
+// Number of nodes between checks of the clock and the shared state
+const std::uint64_t NODE_BATCH = 1024;
+
+// Ordering scores, the hash action is tried first, then captures, pickups, killers and the rest by history
+const int HASH_ACTION_ORDER = 1000000;
+const int CAPTURE_ORDER = 500000;
+const int PICKUP_ORDER = 400000;
+const int FIRST_KILLER_ORDER = 300000;
+const int SECOND_KILLER_ORDER = 299000;
+const int HISTORY_LIMIT = 200000;  // History scores saturate below the killers
+
+/**
+ * @brief Gets the number of nodes searched per second
+ */
+double SearchResult::nodesPerSecond() const {
+    return seconds > 0.0 ? static_cast<double>(nodes) / seconds : 0.0;
+}
+
+/**
+ * @brief Evaluates a position from the view of the player to move
+ * @param game The game to evaluate
+ * @return Positive if the player to move is ahead, negative if they are behind
+ * @note The board terms come from the board's accumulator, so only the inventories are summed here
+ */
+int evaluate(const Game &game) {
+    const EvalWeights &weights = getEvalWeights();
+    const int player1Score = accumulatorScore(game.board.accumulator) + inventoryScore(game.player1, weights) -
+                             inventoryScore(game.player2, weights);
+    return game.currentPlayerID == 1 ? player1Score : -player1Score;
+}
+
+/**
+ * @brief Converts a tablebase entry into a search score
+ * @param entry The entry, for the player to move
+ * @param ply The distance from the root
+ * @return A mate score counting the plies to the end of the game, or 0 for a draw
+ */
+int tablebaseScore(const TablebaseEntry &entry, const int ply) {
+    // Distances are capped so tablebase scores stay beyond MATE_BOUND
+    const int plies = ply + std::min(entry.distance, MATE_SCORE - MATE_BOUND - MAX_SEARCH_DEPTH - MAX_QUIESCENCE_PLIES);
+    switch (entry.result) {
+        case TablebaseResult::WIN:
+            return MATE_SCORE - plies;
+        case TablebaseResult::LOSS:
+            return -MATE_SCORE + plies;
+        default:
+            return 0;
+    }
+}
+
+/**
+ * @brief Moves an action to the front of a list, if it is in the list
+ * @param actions The list to reorder
+ * @param action The action to search first
+ */
+void moveToFront(ActionList &actions, const Action &action) {
+    Action *const found = std::find(actions.begin(), actions.end(), action);
+    if (found != actions.end()) {
+        std::swap(*found, actions[0]);
+    }
+}
+
+/**
+ * @brief Looks up a position in the transposition table under its canonical key
+ * @param table The table to look in
+ * @param game The game, positioned at the position
+ * @param key The canonical key of the position
+ * @param ply The distance from the root
+ * @return The entry, with its best action turned back from the canonical position into this one
+ */
+std::optional<TableEntry> probeCanonical(const TranspositionTable &table, const Game &game, const CanonicalKey &key, const int ply) {
+    std::optional<TableEntry> entry = table.probe(key.hash, ply);
+    if (entry.has_value() && entry->bestAction.has_value()) {
+        entry->bestAction = game.board.symmetries.transform(entry->bestAction.value(), key.symmetry);
+    }
+    return entry;
+}
+
+/**
+ * @brief Stores a position in the transposition table under its canonical key
+ * @param table The table to store in
+ * @param game The game, positioned at the position
+ * @param key The canonical key of the position
+ * @param entry The entry to store, with its best action turned into the canonical position
+ * @param ply The distance from the root
+ */
+void storeCanonical(TranspositionTable &table, const Game &game, const CanonicalKey &key, TableEntry entry, const int ply) {
+    if (entry.bestAction.has_value()) {
+        entry.bestAction = game.board.symmetries.transform(entry.bestAction.value(), key.symmetry);
+    }
+    table.store(key.hash, entry, ply);
+}
+
+/**
+ * @brief Removes root actions that a symmetry of the position makes equivalent to an earlier action
+ * @param game The game, positioned at the root
+ * @param actions The actions of the root, of which the first of each equivalent set is kept
+ * @note Only positions that a symmetry leaves unchanged, such as a symmetric field reflected left to
+ * right, have equivalent actions
+ */
+void pruneSymmetricActions(const Game &game, ActionList &actions) {
+    std::array<Symmetry, NUM_SYMMETRIES> symmetries{};
+    std::size_t numSymmetries = 0;
+    const std::uint64_t hash = game.positionHash();
+    for (std::size_t i = 1; i < NUM_SYMMETRIES; i++) {
+        if (game.symmetricHash(static_cast<Symmetry>(i)) == hash) {
+            symmetries[numSymmetries++] = static_cast<Symmetry>(i);
+        }
+    }
+    if (numSymmetries == 0) {
+        return;
+    }
+    std::size_t kept = 0;
+    for (std::size_t i = 0; i < actions.size; i++) {
+        const Action action = actions[i];
+        const bool equivalent = std::any_of(symmetries.begin(), symmetries.begin() + numSymmetries, [&](const Symmetry symmetry) {
+            return std::find(actions.begin(), actions.begin() + kept, game.board.symmetries.transform(action, symmetry)) != actions.begin() + kept;
+        });
+        if (!equivalent) {
+            actions[kept++] = action;
+        }
+    }
+    actions.size = kept;
+}
+
+/**
+ * @brief Moves the highest scoring of the remaining actions to the next position to search
+ * @param actions The actions, searched up to index
+ * @param scores The ordering scores of the actions, kept in step with them
+ * @param index The position of the next action to search
+ * @return False once every remaining action scores 0, so the rest can be searched in generated order
+ * @note Picking one action at a time avoids sorting the actions that a cutoff means are never searched
+ */
+bool pickNext(ActionList &actions, std::vector<int> &scores, const std::size_t index) {
+    std::size_t best = index;
+    for (std::size_t i = index + 1; i < actions.size; i++) {
+        if (scores[i] > scores[best]) {
+            best = i;
+        }
+    }
+    std::swap(actions[index], actions[best]);
+    std::swap(scores[index], scores[best]);
+    return scores[index] > 0;
+}
+
+/**
+ * @brief Construct a new Searcher object
+ * @param table The transposition table to share results through
+ * @param shared The state shared with the other searchers of a parallel search, or nullptr
+ */
+Searcher::Searcher(TranspositionTable &table, SharedSearchState *shared)
+    : table(table), tablebases(getTablebases()), shared(shared) {}
+
+/**
+ * @brief Resets the searcher for a new search
+ * @param limits The limits of the search, the node limit is shared if the searcher has a shared state
+ */
+void Searcher::prepare(const SearchLimits &limits) {
+    const std::size_t numPlies = limits.maxDepth + 1 + MAX_QUIESCENCE_PLIES;
+    actionLists.resize(numPlies);
+    actionScores.resize(numPlies);
+    killers.assign(numPlies, {});
+    historyScores.assign(2 * MAX_CELLS * MAX_CELLS, 0);
+    nodes = 0;
+    maxNodes = limits.maxNodes;
+    deadline.reset();
+    if (limits.maxSeconds > 0.0) {
+        deadline = std::chrono::steady_clock::now() +
+                   std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(limits.maxSeconds));
+    }
+    stopped = false;
+}
+
+/**
+ * @brief Searches a single root action, so separate searchers can search different root actions
+ * @param game The game to search, which is restored before returning
+ * @param action The action to search
+ * @param depth The depth to search to, including the action
+ * @param alpha The score the player to move is already guaranteed
+ * @param beta The score the opponent is already guaranteed, negated
+ * @return The score of the action from the view of the player to move, meaningless if the search was stopped
+ */
+int Searcher::searchAction(Game &game, const Action &action, const int depth, const int alpha, const int beta) {
+    game.makeMove(action);
+    const int score = -negamax(game, depth - 1, -beta, -alpha, 1);
+    game.unmakeMove();
+    return score;
+}
+
+/**
+ * @brief Chooses a root action from the tablebases, without searching
+ * @param game The game to search, which is restored before returning
+ * @param rootActions The actions of the root position
+ * @return The action leading to the best tablebase result, or std::nullopt if the root is not in the tablebases
+ */
+std::optional<SearchResult> Searcher::probeRoot(Game &game, const ActionList &rootActions) const {
+    if (tablebases.empty() || rootActions.empty() || !tablebases.probe(game).has_value()) {
+        return std::nullopt;
+    }
+    SearchResult result;
+    for (const Action &action : rootActions) {
+        game.makeMove(action);
+        const std::optional<TablebaseEntry> entry = tablebases.probe(game);
+        game.unmakeMove();
+        if (!entry.has_value()) {
+            return std::nullopt;  // every action of a tablebase position leads to another one
+        }
+        const int score = -tablebaseScore(entry.value(), 1);
+        if (!result.bestAction.has_value() || score > result.score) {
+            result.bestAction = action;
+            result.score = score;
+        }
+        result.nodes++;
+    }
+    return result;
+}
+
+/**
+ * @brief Checks if the search stopped before finishing, because a limit was reached or it was cancelled
+ */
+bool Searcher::isStopped() const {
+    return stopped;
+}
+
+/**
+ * @brief Gets the number of nodes visited since the searcher was prepared
+ */
+std::uint64_t Searcher::getNodes() const {
+    return nodes;
+}
+
+/**
+ * @brief Counts a visited node and stops the search if a limit has been reached
+ * @note The clock and the shared state are only checked every NODE_BATCH nodes
+ */
+void Searcher::countNode() {
+    nodes++;
+    if (shared == nullptr && nodes >= maxNodes) {
+        stopped = true;
+    }
+    if (nodes % NODE_BATCH != 0) {
+        return;
+    }
+    if (deadline.has_value() && std::chrono::steady_clock::now() >= deadline.value()) {
+        stopped = true;
+    }
+    if (shared != nullptr) {
+        if (stopped || shared->nodes.fetch_add(NODE_BATCH, std::memory_order_relaxed) + NODE_BATCH >= maxNodes) {
+            shared->cancellation.cancel();
+        }
+        stopped = shared->cancellation.isCancelled();
+    }
+}
+
+/**
+ * @brief Searches a position with iterative deepening until a limit is reached
+ * @param game The game to search, which is restored before returning
+ * @param limits The depth and node limits of the search
+ * @return The best action found by the last completed iteration and statistics of the search
+ */
+SearchResult Searcher::search(Game &game, const SearchLimits &limits) {
+    const auto start = std::chrono::steady_clock::now();
+    prepare(limits);
+
+    SearchResult result;
+    ActionList &rootActions = actionLists[0];
+    generateActions(game, rootActions);
+    pruneSymmetricActions(game, rootActions);
+    if (std::optional<SearchResult> solved = probeRoot(game, rootActions); solved.has_value()) {
+        solved->seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        return solved.value();
+    }
+    const CanonicalKey key = game.canonicalKey();
+    const std::optional<TableEntry> entry = probeCanonical(table, game, key, 0);
+    orderActions(game, rootActions, entry.has_value() ? entry->bestAction : std::nullopt);
+    if (!rootActions.empty()) {
+        result.bestAction = rootActions[0];
+    }
+    for (int depth = 1; depth <= limits.maxDepth && !rootActions.empty(); depth++) {
+        Action bestAction = result.bestAction.value();
+        const int score = searchRoot(game, depth, rootActions, bestAction);
+        if (stopped) {
+            break;  // an unfinished iteration may not have looked at the best action
+        }
+        result.bestAction = bestAction;
+        result.score = score;
+        result.depth = depth;
+        storeCanonical(table, game, key, {score, depth, Bound::EXACT, bestAction}, 0);
+        // Searching the previous best action first makes the next iteration's cutoffs much earlier
+        moveToFront(rootActions, bestAction);
+        if (score >= MATE_BOUND || score <= -MATE_BOUND) {
+            break;  // the result is already known
+        }
+    }
+    result.nodes = nodes;
+    result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return result;
+}
+
+/**
+ * @brief Searches every root action to a fixed depth
+ * @param game The game to search
+ * @param depth The depth to search to
+ * @param rootActions The actions of the root position, best first
+ * @param bestAction The best action found, left unchanged if the search is stopped before the first action is searched
+ * @return The score of the best action
+ */
+int Searcher::searchRoot(Game &game, const int depth, ActionList &rootActions, Action &bestAction) {
+    int alpha = -MATE_SCORE;
+    for (const Action &action : rootActions) {
+        const int score = searchAction(game, action, depth, alpha, MATE_SCORE);
+        if (stopped) {
+            break;
+        }
+        if (score > alpha) {
+            alpha = score;
+            bestAction = action;
+        }
+    }
+    return alpha;
+}
+
+/**
+ * @brief Scores a position with a negamax alpha-beta search
+ * @param game The game to search
+ * @param depth The remaining depth to search
+ * @param alpha The score the player to move is already guaranteed
+ * @param beta The score the opponent is already guaranteed, negated
+ * @param ply The distance from the root
+ * @return The score of the position from the view of the player to move
+ * @note A player with no pieces or no legal actions has lost
+ */
+int Searcher::negamax(Game &game, int depth, int alpha, int beta, const int ply) {
+    countNode();
+    if (game.getAllyPlayer().numPieces == 0) {
+        return -MATE_SCORE + ply;
+    }
+    if (stopped) {
+        return 0;
+    }
+    if (const std::optional<TablebaseEntry> solved = tablebases.probe(game); solved.has_value()) {
+        return tablebaseScore(solved.value(), ply);
+    }
+    if (depth == 0) {
+        return quiescence(game, alpha, beta, ply);
+    }
+
+    const CanonicalKey key = game.canonicalKey();
+    const std::optional<TableEntry> entry = probeCanonical(table, game, key, ply);
+    if (entry.has_value() && entry->depth >= depth) {
+        if (entry->bound == Bound::EXACT ||
+            (entry->bound == Bound::LOWER && entry->score >= beta) ||
+            (entry->bound == Bound::UPPER && entry->score <= alpha)) {
+            return entry->score;
+        }
+    }
+
+    ActionList &actions = actionLists[ply];
+    generateActions(game, actions);
+    if (actions.empty()) {
+        return -MATE_SCORE + ply;
+    }
+    std::vector<int> &scores = actionScores[ply];
+    scoreActions(game, actions, scores, entry.has_value() ? entry->bestAction : std::nullopt, ply);
+
+    const int originalAlpha = alpha;
+    int bestScore = -MATE_SCORE;
+    Action bestAction = actions[0];
+    bool ordered = true;
+    for (std::size_t i = 0; i < actions.size; i++) {
+        if (ordered) {
+            ordered = pickNext(actions, scores, i);
+        }
+        const Action action = actions[i];
+        game.makeMove(action);
+        const int score = -negamax(game, depth - 1, -beta, -alpha, ply + 1);
+        game.unmakeMove();
+        if (stopped) {
+            return 0;  // unfinished, the caller discards the score and nothing is stored
+        }
+        if (score > bestScore) {
+            bestScore = score;
+            bestAction = action;
+        }
+        if (score > alpha) {
+            alpha = score;
+        }
+        if (alpha >= beta) {
+            recordCutoff(game, action, depth, ply);
+            break;
+        }
+    }
+    const Bound bound = bestScore >= beta ? Bound::LOWER : bestScore <= originalAlpha ? Bound::UPPER : Bound::EXACT;
+    storeCanonical(table, game, key, {bestScore, depth, bound, bestAction}, ply);
+    return bestScore;
+}
+
+/**
+ * @brief Extends a leaf with a search of captures and powerup pickups only, until the position is quiet
+ * @param game The game to search
+ * @param alpha The score the player to move is already guaranteed
+ * @param beta The score the opponent is already guaranteed, negated
+ * @param ply The distance from the root
+ * @return The score of the position from the view of the player to move
+ * @note The player to move may always stand pat on the static evaluation instead of capturing
+ */
+int Searcher::quiescence(Game &game, int alpha, int beta, const int ply) {
+    if (game.getAllyPlayer().numPieces == 0) {
+        return -MATE_SCORE + ply;
+    }
+    const int standPat = evaluate(game);
+    if (standPat >= beta || ply + 1 >= static_cast<int>(actionLists.size())) {
+        return standPat;
+    }
+    if (standPat > alpha) {
+        alpha = standPat;
+    }
+    ActionList &actions = actionLists[ply];
+    generateNoisyActions(game, actions);
+    std::vector<int> &scores = actionScores[ply];
+    scoreActions(game, actions, scores, std::nullopt, ply);
+    int bestScore = standPat;
+    for (std::size_t i = 0; i < actions.size; i++) {
+        pickNext(actions, scores, i);
+        countNode();
+        game.makeMove(actions[i]);
+        const int score = -quiescence(game, -beta, -alpha, ply + 1);
+        game.unmakeMove();
+        if (stopped) {
+            return 0;
+        }
+        if (score > bestScore) {
+            bestScore = score;
+        }
+        if (score > alpha) {
+            alpha = score;
+        }
+        if (alpha >= beta) {
+            break;
+        }
+    }
+    return bestScore;
+}
+
+/**
+ * @brief Gives every action an ordering score, higher scores are searched first
+ * @param game The game, before the actions
+ * @param actions The actions to score
+ * @param scores Filled with the score of each action
+ * @param hashAction The best action stored in the transposition table, if any
+ * @param ply The distance from the root, for the killers
+ * @note Captures are ordered by the value of the captured piece and pickups by the value of the powerup
+ */
+void Searcher::scoreActions(const Game &game, const ActionList &actions, std::vector<int> &scores,
+                            const std::optional<Action> &hashAction, const int ply) const {
+    scores.resize(actions.size);
+    const Cell &targetCell = game.getTargetCell();
+    const Cell &targetBishopCell = game.getTargetBishopCell();
+    const EvalWeights &weights = getEvalWeights();
+    for (std::size_t i = 0; i < actions.size; i++) {
+        const Action &action = actions[i];
+        if (action == hashAction) {
+            scores[i] = HASH_ACTION_ORDER;
+            continue;
+        }
+        if (action.type == ActionType::MOVE || action.type == ActionType::HOP) {
+            const Cell &destination = game.board.field.cells[action.target];
+            if (destination == targetBishopCell) {
+                scores[i] = CAPTURE_ORDER + weights.piece + weights.bishop;
+                continue;
+            } else if (destination == targetCell) {
+                scores[i] = CAPTURE_ORDER + weights.piece;
+                continue;
+            } else if (const Powerup pickup = cellToPowerup(destination); pickup != Powerup::COUNT) {
+                scores[i] = PICKUP_ORDER + weights.powerups[static_cast<std::size_t>(pickup)];
+                continue;
+            }
+        }
+        if (action == killers[ply][0]) {
+            scores[i] = FIRST_KILLER_ORDER;
+        } else if (action == killers[ply][1]) {
+            scores[i] = SECOND_KILLER_ORDER;
+        } else if (action.type == ActionType::MOVE || action.type == ActionType::HOP) {
+            scores[i] = historyScores[historyIndex(game, action)];
+        } else {
+            scores[i] = 0;
+        }
+    }
+}
+
+/**
+ * @brief Sorts a list of actions into search order, for root positions
+ * @param game The game, before the actions
+ * @param actions The actions to sort
+ * @param hashAction The best action stored in the transposition table, if any
+ */
+void Searcher::orderActions(const Game &game, ActionList &actions, const std::optional<Action> &hashAction) {
+    std::vector<int> &scores = actionScores[0];
+    scoreActions(game, actions, scores, hashAction, 0);
+    std::vector<std::pair<int, Action>> scored;
+    scored.reserve(actions.size);
+    for (std::size_t i = 0; i < actions.size; i++) {
+        scored.emplace_back(scores[i], actions[i]);
+    }
+    std::stable_sort(scored.begin(), scored.end(), [](const auto &first, const auto &second) {
+        return first.first > second.first;
+    });
+    for (std::size_t i = 0; i < actions.size; i++) {
+        actions[i] = scored[i].second;
+    }
+}
+
+/**
+ * @brief Remembers a quiet action that caused a beta cutoff, so it is tried early in sibling positions
+ * @param game The game, before the action
+ * @param action The action that caused the cutoff
+ * @param depth The remaining depth, deeper cutoffs count for more
+ * @param ply The distance from the root
+ */
+void Searcher::recordCutoff(const Game &game, const Action &action, const int depth, const int ply) {
+    if (isNoisy(game, action)) {
+        return;  // already ordered first
+    }
+    if (killers[ply][0] != action) {
+        killers[ply][1] = killers[ply][0];
+        killers[ply][0] = action;
+    }
+    if (action.type == ActionType::MOVE || action.type == ActionType::HOP) {
+        int &history = historyScores[historyIndex(game, action)];
+        history = std::min(history + depth * depth, HISTORY_LIMIT);
+    }
+}
+
+/**
+ * @brief Gets the index into the history table of a move by the player to move
+ */
+std::size_t Searcher::historyIndex(const Game &game, const Action &action) {
+    return (static_cast<std::size_t>(game.currentPlayerID - 1) * MAX_CELLS + action.origin) * MAX_CELLS + action.target;
+}
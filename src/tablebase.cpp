@@ -0,0 +1,254 @@
+#include "tablebase.h"
+
+#include <algorithm>  // std::sort, std::min
+#include <stdexcept>
+#include <utility>  // std::pair
+
+#include "board.h"
+#include "game.h"
+#include "globals.h"
+#include "player.h"
+
+const std::filesystem::path TABLEBASE_DIRECTORY = EXE_PATH / "tablebases";
+
+// Extension of tablebase files
+const std::string TABLEBASE_EXTENSION = ".dtb";
+
+/**
+ * @brief Unpacks an entry of a tablebase file
+ */
+TablebaseEntry decodeTablebaseEntry(const std::uint16_t data) {
+    return {static_cast<TablebaseResult>(data >> TABLEBASE_DISTANCE_BITS), data & MAX_TABLEBASE_DISTANCE};
+}
+
+/**
+ * @brief Packs an entry for a tablebase file
+ */
+std::uint16_t encodeTablebaseEntry(const TablebaseEntry &entry) {
+    return static_cast<std::uint16_t>((static_cast<int>(entry.result) << TABLEBASE_DISTANCE_BITS) | entry.distance);
+}
+
+/**
+ * @brief Construct a new Tablebase Index object
+ * @param numCells The number of cells of the board
+ * @param blank The blank cells of the terrain
+ * @param barrier The barriers of the terrain
+ * @param maxDots The most dots of each side
+ */
+TablebaseIndex::TablebaseIndex(const int numCells, const Bitboard &blank, const Bitboard &barrier, const int maxDots)
+    : maxDots(maxDots) {
+    cellRanks.fill(0);
+    for (int i = 0; i < numCells; i++) {
+        if (!blank.test(i) && !barrier.test(i)) {
+            cellRanks[i] = static_cast<std::uint8_t>(cells.size());
+            cells.push_back(static_cast<std::uint8_t>(i));
+        }
+    }
+    binomials.assign(cells.size() + 1, {});
+    for (std::size_t n = 0; n <= cells.size(); n++) {
+        binomials[n][0] = 1;
+        for (int k = 1; k <= MAX_TABLEBASE_DOTS && static_cast<std::size_t>(k) <= n; k++) {
+            binomials[n][k] = binomials[n - 1][k - 1] + (static_cast<std::size_t>(k) < n ? binomials[n - 1][k] : 0);
+        }
+    }
+    for (int k = 0; k <= maxDots; k++) {
+        offsets[k + 1] = offsets[k] + (binomials[cells.size()][k] << k);
+    }
+    numConfigs = offsets[maxDots + 1];
+}
+
+/**
+ * @brief Ranks a side's pieces
+ * @param config The pieces, with their cells in ascending order
+ * @return The rank of the pieces, from 0 to getNumConfigs() - 1
+ */
+std::uint32_t TablebaseIndex::rankConfig(const SideConfig &config) const {
+    std::uint32_t combination = 0;
+    for (int i = 0; i < config.count; i++) {
+        combination += binomials[cellRanks[config.cells[i]]][i + 1];
+    }
+    return offsets[config.count] + (combination << config.count) + config.bishops;
+}
+
+/**
+ * @brief Ranks a player's pieces
+ * @param board The board the player is on
+ * @param player The player to rank
+ * @return The rank of the player's pieces, or std::nullopt if they have more than maxDots
+ */
+std::optional<std::uint32_t> TablebaseIndex::rankPlayer(const Board &board, const Player &player) const {
+    if (player.numPieces > maxDots) {
+        return std::nullopt;
+    }
+    // maxDots is at most MAX_TABLEBASE_DOTS, clamped again so the compiler can see every access stays in the array
+    const int count = std::min(player.numPieces, MAX_TABLEBASE_DOTS);
+    // The unused slots hold the largest cell index, so sorting the whole array leaves them at the end
+    std::array<std::pair<std::uint8_t, bool>, MAX_TABLEBASE_DOTS> pieces;
+    pieces.fill({UINT8_MAX, false});
+    for (int i = 0; i < count; i++) {
+        pieces[i] = {static_cast<std::uint8_t>(board.toIndex(player.pieces[i].coord())), player.pieces[i].isBishop};
+    }
+    std::sort(pieces.begin(), pieces.end());
+    SideConfig config;
+    config.count = count;
+    for (int i = 0; i < count; i++) {
+        config.cells[i] = pieces[i].first;
+        config.bishops |= static_cast<std::uint8_t>(pieces[i].second) << i;
+    }
+    return rankConfig(config);
+}
+
+/**
+ * @brief Lists every set of a side's pieces
+ * @return The sets, indexed by their rank
+ */
+std::vector<SideConfig> TablebaseIndex::listConfigs() const {
+    std::vector<SideConfig> configs(numConfigs);
+    const int numCells = static_cast<int>(cells.size());
+    for (int count = 0; count <= maxDots && count <= numCells; count++) {
+        // Step through every combination of count cell ranks in lexicographic order
+        std::array<int, MAX_TABLEBASE_DOTS> chosen{};
+        for (int i = 0; i < count; i++) {
+            chosen[i] = i;
+        }
+        while (true) {
+            SideConfig config;
+            config.count = count;
+            for (int i = 0; i < count; i++) {
+                config.cells[i] = cells[chosen[i]];
+                config.occupied.set(config.cells[i]);
+            }
+            for (int bishops = 0; bishops < (1 << count); bishops++) {
+                config.bishops = static_cast<std::uint8_t>(bishops);
+                configs[rankConfig(config)] = config;
+            }
+            int i = count - 1;
+            while (i >= 0 && chosen[i] == numCells - count + i) {
+                i--;
+            }
+            if (i < 0) {
+                break;
+            }
+            chosen[i]++;
+            for (int j = i + 1; j < count; j++) {
+                chosen[j] = chosen[j - 1] + 1;
+            }
+        }
+    }
+    return configs;
+}
+
+/**
+ * @brief Opens a tablebase file
+ * @param path The path to the file
+ * @throws std::runtime_error if the file cannot be read or is not a tablebase of this version
+ */
+Tablebase::Tablebase(const std::filesystem::path &path) : file(path) {
+    header = reinterpret_cast<const TablebaseHeader *>(file.data());
+    if (file.size() < sizeof(TablebaseHeader) || header->magic != TABLEBASE_MAGIC || header->version != TABLEBASE_VERSION ||
+        header->maxDots < 1 || header->maxDots > MAX_TABLEBASE_DOTS || header->length * header->width > MAX_CELLS ||
+        file.size() != sizeof(TablebaseHeader) + header->numPositions * sizeof(std::uint16_t)) {
+        throw std::runtime_error("Not a valid tablebase: " + path.string());
+    }
+    index = std::make_unique<TablebaseIndex>(header->length * header->width, Bitboard{header->blank}, Bitboard{header->barrier}, header->maxDots);
+    if (index->getNumPositions() != header->numPositions) {
+        throw std::runtime_error("Tablebase does not match its terrain: " + path.string());
+    }
+    entries = reinterpret_cast<const std::uint16_t *>(file.data() + sizeof(TablebaseHeader));
+}
+
+/**
+ * @brief Looks up a position
+ * @param game The game to look up, which must satisfy isTablebasePosition
+ * @return The solved position, or std::nullopt if the position is not in this tablebase
+ */
+std::optional<TablebaseEntry> Tablebase::probe(const Game &game) const {
+    const Board &board = game.board;
+    if (board.length != header->length || board.width != header->width ||
+        board.plane(BLANK_CELL).words != header->blank || board.plane(BARRIER_CELL).words != header->barrier) {
+        return std::nullopt;
+    }
+    const std::optional<std::uint32_t> player1Config = index->rankPlayer(board, game.player1);
+    const std::optional<std::uint32_t> player2Config = index->rankPlayer(board, game.player2);
+    if (!player1Config.has_value() || !player2Config.has_value()) {
+        return std::nullopt;
+    }
+    const TablebaseEntry entry = decodeTablebaseEntry(entries[index->position(game.currentPlayerID - 1, player1Config.value(), player2Config.value())]);
+    if (entry.result == TablebaseResult::INVALID) {
+        return std::nullopt;
+    }
+    return entry;
+}
+
+/**
+ * @brief Opens every tablebase in a directory
+ * @param directory The directory to look in, which need not exist
+ * @note Files that are not valid tablebases are skipped and listed in getSkipped
+ */
+TablebaseSet::TablebaseSet(const std::filesystem::path &directory) {
+    std::error_code error;
+    if (!std::filesystem::is_directory(directory, error)) {
+        return;
+    }
+    for (const auto &file : std::filesystem::directory_iterator(directory, error)) {
+        if (file.path().extension() != TABLEBASE_EXTENSION) {
+            continue;
+        }
+        try {
+            tablebases.push_back(std::make_unique<Tablebase>(file.path()));
+        } catch (const std::runtime_error &e) {
+            skipped.emplace_back(e.what());
+        }
+    }
+}
+
+/**
+ * @brief Looks up a position in every tablebase
+ * @param game The game to look up
+ * @return The solved position, or std::nullopt if it is not in any tablebase
+ */
+std::optional<TablebaseEntry> TablebaseSet::probe(const Game &game) const {
+    if (tablebases.empty() || !isTablebasePosition(game)) {
+        return std::nullopt;
+    }
+    for (const auto &tablebase : tablebases) {
+        if (const std::optional<TablebaseEntry> entry = tablebase->probe(game); entry.has_value()) {
+            return entry;
+        }
+    }
+    return std::nullopt;
+}
+
+/**
+ * @brief Checks if a position has nothing random left in it, so its outcome can be solved ahead of time
+ * @param game The game to check
+ * @return True if no powerups will be placed, neither player holds a powerup and the field has no
+ * powerups, portals or crumblies
+ */
+bool isTablebasePosition(const Game &game) {
+    if (game.placesPowerups() || game.player1.hasPowerups() || game.player2.hasPowerups()) {
+        return false;
+    }
+    const Board &board = game.board;
+    if ((board.plane(PORTAL_CELL) | board.plane(CRUMBLY_CELL) | board.plane(HOP_CELL) | board.plane(PORTAL_POWER_CELL) |
+         board.plane(DESTROYER_CELL) | board.plane(BISHOP_POWER_CELL)).any()) {
+        return false;
+    }
+    // A crumbly under a piece is hidden by the piece
+    for (const Player *player : {&game.player1, &game.player2}) {
+        for (const Piece &piece : player->getPieces()) {
+            if (game.cellInfo[board.toIndex(piece.coord())].isCrumbly) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Gets the tablebases, opened from TABLEBASE_DIRECTORY the first time they are needed
+ */
+const TablebaseSet &getTablebases() {
+    static const TablebaseSet tablebases(TABLEBASE_DIRECTORY);
+    return tablebases;
+}
@@ -0,0 +1,269 @@
+#include <algorithm>  // std::min
+#include <atomic>
+#include <format>  // std::format
+#include <fstream>
+#include <ostream>
+#include <stdexcept>
+#include <vector>
+
+#include "move_generator.h"
+#include "other_tools.h"
+#include "scheduler.h"
+#include "slide_table.h"
+#include "tablebase.h"
+
+// Most positions a tablebase is generated with, 2 bytes each
+const std::uint64_t MAX_TABLEBASE_POSITIONS = std::uint64_t{1} << 31;
+
+// Player 1 configs handed to each task of a pass
+const std::uint32_t CONFIGS_PER_TASK = 16;
+
+/**
+ * @brief Solves every position of a tablebase by retrograde analysis
+ * @note The solver works in passes. The first marks impossible positions and the positions where the
+ * player to move has already lost, then pass d marks every position that is won in d plies because
+ * some action leads to a position lost in d - 1, and every position lost in d plies because every
+ * action leads to a position won in fewer than d. Positions still unsolved once a pass changes
+ * nothing are draws. Each pass only reads entries solved by earlier passes, so the passes give
+ * the same distances whichever order the workers visit positions in.
+ * Moves are made on the index's own piece sets, using the same slide table as the game, because
+ * without powerups, portals and crumblies the only actions are moves and captures
+ */
+struct TablebaseSolver {
+    const TablebaseIndex &index;
+    const std::vector<SideConfig> &configs;
+    const SlideTable &slides;
+    const Bitboard &barrier;
+    std::vector<std::uint16_t> &entries;
+
+    /**
+     * @brief Calls a function with the resulting piece sets of every move of a side
+     * @tparam Visit A callable taking the mover's and the opponent's new SideConfig
+     * @param mover The pieces of the side to move
+     * @param opponent The pieces of the other side
+     * @param visit The function to call, stops the moves early by returning true
+     * @return True if the function stopped the moves early
+     */
+    template <typename Visit>
+    bool forEachMove(const SideConfig &mover, const SideConfig &opponent, Visit &&visit) const {
+        for (int i = 0; i < mover.count; i++) {
+            const bool isBishop = (mover.bishops >> i) & 1;
+            const std::size_t firstVector = firstSlideVector(isBishop, false);
+            for (std::size_t v = firstVector; v < firstVector + 4; v++) {
+                const std::uint8_t stop = slides.stop(v, mover.cells[i]);
+                if (stop == NO_STOP || barrier.test(stop) || mover.occupied.test(stop)) {
+                    continue;
+                }
+                if (visit(movePiece(mover, i, stop), opponent.occupied.test(stop) ? removePiece(opponent, stop) : opponent)) {
+                    return true;
+                }
+            }
+        }
+        return false;
+    }
+
+    /**
+     * @brief Gets the index of the position after a move
+     * @param sideToMove The side that made the move
+     */
+    std::uint64_t successor(const int sideToMove, const SideConfig &mover, const SideConfig &opponent) const {
+        const std::uint32_t moverConfig = index.rankConfig(mover);
+        const std::uint32_t opponentConfig = index.rankConfig(opponent);
+        return sideToMove == 0 ? index.position(1, moverConfig, opponentConfig) : index.position(0, opponentConfig, moverConfig);
+    }
+
+    /**
+     * @brief Solves the positions that need no moves looked up: impossible ones, finished games and stalemates
+     */
+    TablebaseEntry initialEntry(const SideConfig &mover, const SideConfig &opponent) const {
+        if ((mover.occupied & opponent.occupied).any() || opponent.count == 0) {
+            return {TablebaseResult::INVALID, 0};
+        }
+        if (mover.count == 0) {
+            return {TablebaseResult::LOSS, 0};  // the opponent has just captured the last piece
+        }
+        // A player with no legal actions concedes
+        const bool hasMove = forEachMove(mover, opponent, [](const SideConfig &, const SideConfig &) { return true; });
+        return hasMove ? TablebaseEntry{TablebaseResult::DRAW, 0} : TablebaseEntry{TablebaseResult::LOSS, 0};
+    }
+
+    /**
+     * @brief Tries to solve a position with the entries solved by earlier passes
+     * @param pass The number of the pass, the distance of anything it solves
+     * @return The entry, still a draw if the position cannot be solved yet
+     */
+    TablebaseEntry passEntry(const int sideToMove, const SideConfig &mover, const SideConfig &opponent, const int pass) const {
+        bool allWon = true;
+        const bool won = forEachMove(mover, opponent, [&](const SideConfig &newMover, const SideConfig &newOpponent) {
+            const std::uint16_t data = std::atomic_ref<std::uint16_t>(entries[successor(sideToMove, newMover, newOpponent)]).load(std::memory_order_relaxed);
+            const TablebaseEntry entry = decodeTablebaseEntry(data);
+            if (entry.distance >= pass || entry.result == TablebaseResult::DRAW) {
+                allWon = false;  // solved during this pass, or not solved yet
+                return false;
+            }
+            if (entry.result == TablebaseResult::LOSS) {
+                return true;
+            }
+            return false;
+        });
+        if (won) {
+            return {TablebaseResult::WIN, pass};
+        }
+        return allWon ? TablebaseEntry{TablebaseResult::LOSS, pass} : TablebaseEntry{TablebaseResult::DRAW, 0};
+    }
+
+    /**
+     * @brief Runs a pass over every position with player 1's pieces in a range of configs
+     * @param pass The pass to run, 0 for the initial pass
+     * @return The number of positions solved
+     */
+    std::uint64_t runPass(const int pass, const std::uint32_t firstConfig, const std::uint32_t lastConfig) const {
+        std::uint64_t solved = 0;
+        const std::uint32_t numConfigs = index.getNumConfigs();
+        for (int sideToMove = 0; sideToMove < 2; sideToMove++) {
+            for (std::uint32_t player1Config = firstConfig; player1Config < lastConfig; player1Config++) {
+                for (std::uint32_t player2Config = 0; player2Config < numConfigs; player2Config++) {
+                    std::atomic_ref<std::uint16_t> data(entries[index.position(sideToMove, player1Config, player2Config)]);
+                    if (pass > 0 && decodeTablebaseEntry(data.load(std::memory_order_relaxed)).result != TablebaseResult::DRAW) {
+                        continue;
+                    }
+                    const SideConfig &mover = configs[sideToMove == 0 ? player1Config : player2Config];
+                    const SideConfig &opponent = configs[sideToMove == 0 ? player2Config : player1Config];
+                    const TablebaseEntry entry = pass == 0 ? initialEntry(mover, opponent) : passEntry(sideToMove, mover, opponent, pass);
+                    if (entry.result != TablebaseResult::DRAW) {
+                        data.store(encodeTablebaseEntry(entry), std::memory_order_relaxed);
+                        solved += entry.result != TablebaseResult::INVALID;
+                    }
+                }
+            }
+        }
+        return solved;
+    }
+
+    /**
+     * @brief Moves a piece of a side
+     * @param config The side's pieces
+     * @param piece The position of the piece in config
+     * @param destination The cell index the piece moves to
+     * @return The side's pieces after the move, with their cells in ascending order
+     */
+    static SideConfig movePiece(const SideConfig &config, const int piece, const std::uint8_t destination) {
+        const bool isBishop = (config.bishops >> piece) & 1;
+        SideConfig moved = removePiece(config, config.cells[piece]);
+        int slot = moved.count;
+        while (slot > 0 && moved.cells[slot - 1] > destination) {
+            moved.cells[slot] = moved.cells[slot - 1];
+            slot--;
+        }
+        const std::uint8_t below = moved.bishops & ((1 << slot) - 1);
+        moved.bishops = static_cast<std::uint8_t>(below | (isBishop << slot) | ((moved.bishops & ~((1 << slot) - 1)) << 1));
+        moved.cells[slot] = destination;
+        moved.occupied.set(destination);
+        moved.count++;
+        return moved;
+    }
+
+    /**
+     * @brief Removes a piece from a side
+     * @param config The side's pieces
+     * @param cell The cell index of the piece
+     * @return The side's pieces without the piece
+     */
+    static SideConfig removePiece(const SideConfig &config, const std::uint8_t cell) {
+        SideConfig removed = config;
+        int piece = 0;
+        while (config.cells[piece] != cell) {
+            piece++;
+        }
+        for (int i = piece; i + 1 < config.count; i++) {
+            removed.cells[i] = config.cells[i + 1];
+        }
+        const std::uint8_t below = config.bishops & ((1 << piece) - 1);
+        removed.bishops = static_cast<std::uint8_t>(below | ((config.bishops >> (piece + 1)) << piece));
+        removed.occupied.reset(cell);
+        removed.count--;
+        return removed;
+    }
+};
+
+/**
+ * @brief Solves every position of a map with up to a number of dots per side and writes the tablebase to disk
+ * @param map The map to solve, its barriers and blank cells are the terrain of the tablebase
+ * @param maxDots The most dots of each side
+ * @param threads The number of threads to solve with
+ * @param log The stream progress is reported to
+ * @return The path the tablebase was written to
+ * @throws std::invalid_argument if the map is generated at random or the tablebase would be too large
+ * @throws std::runtime_error if the tablebase cannot be written
+ * @note Only positions without powerups, portals and crumblies are solved, and the tablebase is only
+ * probed in games where no more powerups will be placed
+ */
+std::filesystem::path generateTablebase(const Map &map, const int maxDots, const int threads, std::ostream &log) {
+    if (map == Map::RANDOM) {
+        throw std::invalid_argument("Tablebases can only be generated for fixed maps");
+    }
+    if (maxDots < 1 || maxDots > MAX_TABLEBASE_DOTS) {
+        throw std::invalid_argument(std::format("Dots per side must be between 1 and {}", MAX_TABLEBASE_DOTS));
+    }
+    const Field field = readMap(map);
+    const int numCells = field.length * field.width;
+    Bitboard blank;
+    Bitboard barrier;
+    for (int i = 0; i < numCells; i++) {
+        if (field.cells[i] == BLANK_CELL) {
+            blank.set(i);
+        } else if (field.cells[i] == BARRIER_CELL) {
+            barrier.set(i);
+        }
+    }
+    const TablebaseIndex index(numCells, blank, barrier, maxDots);
+    if (index.getNumPositions() > MAX_TABLEBASE_POSITIONS) {
+        throw std::invalid_argument(std::format("{} positions are too many, try fewer dots", index.getNumPositions()));
+    }
+    SlideTable slides;
+    visitGeometry(field.length, field.width, [&slides, &blank](const auto &geometry) {
+        slides.build(geometry, blank);
+    });
+    const std::vector<SideConfig> configs = index.listConfigs();
+    std::vector<std::uint16_t> entries(index.getNumPositions(), encodeTablebaseEntry({TablebaseResult::DRAW, 0}));
+    const TablebaseSolver solver{index, configs, slides, barrier, entries};
+
+    log << std::format("Solving {} positions of {} with up to {} dots per side on {} threads",
+                       index.getNumPositions(), mapToString(map), maxDots, threads)
+        << std::endl;
+    TaskScheduler scheduler(threads, 0);
+    std::uint64_t totalSolved = 0;
+    for (int pass = 0;; pass++) {
+        if (pass > MAX_TABLEBASE_DISTANCE) {
+            throw std::runtime_error("Tablebase distances do not fit in an entry");
+        }
+        std::atomic<std::uint64_t> solved{0};
+        TaskGroup group;
+        for (std::uint32_t first = 0; first < index.getNumConfigs(); first += CONFIGS_PER_TASK) {
+            const std::uint32_t last = std::min(first + CONFIGS_PER_TASK, index.getNumConfigs());
+            scheduler.spawn(group, [&solver, &solved, pass, first, last](Worker &) {
+                solved.fetch_add(solver.runPass(pass, first, last), std::memory_order_relaxed);
+            });
+        }
+        scheduler.wait(group);
+        totalSolved += solved.load();
+        if (pass > 0 && solved.load() == 0) {
+            break;
+        }
+        log << std::format("Pass {}: {} positions solved", pass, solved.load()) << std::endl;
+    }
+
+    TablebaseHeader header{TABLEBASE_MAGIC, TABLEBASE_VERSION, static_cast<std::uint8_t>(field.length),
+                           static_cast<std::uint8_t>(field.width), static_cast<std::uint8_t>(maxDots), 0,
+                           index.getNumPositions(), blank.words, barrier.words};
+    std::filesystem::create_directories(TABLEBASE_DIRECTORY);
+    const std::filesystem::path path = TABLEBASE_DIRECTORY / std::format("{}_{}.dtb", mapToString(map), maxDots);
+    std::ofstream file(path, std::ios::binary);
+    file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    file.write(reinterpret_cast<const char *>(entries.data()), static_cast<std::streamsize>(entries.size() * sizeof(std::uint16_t)));
+    if (!file) {
+        throw std::runtime_error("Could not write tablebase: " + path.string());
+    }
+    log << std::format("Solved {} positions, the rest are draws or cannot occur. Written to {}", totalSolved, path.string()) << std::endl;
+    return path;
+}
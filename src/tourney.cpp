@@ -0,0 +1,366 @@
+#include "tourney.h"
+
+#include <algorithm>  // std::clamp
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <format>  // std::format
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <sstream>
+#include <stdexcept>
+
+#include "game.h"
+#include "mcts.h"
+#include "move_generator.h"
+#include "random.h"
+#include "scheduler.h"
+#include "search.h"
+#include "settings_data.h"
+#include "transposition_table.h"
+
+// Games between progress reports
+const int TOURNEY_REPORT_INTERVAL = 20;
+
+// Normal quantile of the two-sided 95% confidence interval
+const double CONFIDENCE_QUANTILE = 1.959964;
+
+/**
+ * @brief Describes a configuration for the tournament report
+ */
+std::string PlayerConfig::describe() const {
+    if (type == PlayerType::MCTS) {
+        return std::format("MCTS {}ms, {}MB", milliseconds, tableMegabytes);
+    }
+    std::string description = std::format("alpha-beta depth {}, {} nodes", depth, nodes);
+    if (milliseconds > 0) {
+        description += std::format(", {}ms", milliseconds);
+    }
+    return description + std::format(", {}MB", tableMegabytes);
+}
+
+/**
+ * @brief Reads a configuration from comma separated settings, e.g. "type=ab,depth=6,nodes=50000"
+ * @param spec The settings: type (ab or mcts), depth, nodes, ms and hash (in MB)
+ * @return The configuration, with the settings not given at their defaults
+ * @throws std::invalid_argument if a setting is unknown or out of range, or MCTS has no time
+ */
+PlayerConfig parsePlayerConfig(const std::string &spec) {
+    PlayerConfig config;
+    std::istringstream settings(spec);
+    std::string setting;
+    while (std::getline(settings, setting, ',')) {
+        const std::size_t equals = setting.find('=');
+        if (equals == std::string::npos) {
+            throw std::invalid_argument("Expected key=value: " + setting);
+        }
+        const std::string key = setting.substr(0, equals);
+        const std::string value = setting.substr(equals + 1);
+        if (key == "type") {
+            if (value != "ab" && value != "mcts") {
+                throw std::invalid_argument("Unknown type: " + value);
+            }
+            config.type = value == "mcts" ? PlayerType::MCTS : PlayerType::COMPUTER;
+        } else if (key == "depth") {
+            config.depth = std::clamp(std::stoi(value), 1, MAX_SEARCH_DEPTH);
+        } else if (key == "nodes") {
+            config.nodes = std::stoull(value);
+        } else if (key == "ms") {
+            config.milliseconds = std::stoi(value);
+        } else if (key == "hash") {
+            config.tableMegabytes = std::clamp<std::size_t>(std::stoull(value), MIN_TABLE_MEGABYTES, MAX_TABLE_MEGABYTES);
+        } else {
+            throw std::invalid_argument("Unknown setting: " + key);
+        }
+    }
+    if (config.type == PlayerType::MCTS && config.milliseconds <= 0) {
+        throw std::invalid_argument("MCTS needs a time per action (ms)");
+    }
+    return config;
+}
+
+/**
+ * @brief Gets the log-likelihood ratio below which the SPRT accepts elo0
+ */
+double SprtBounds::lower() const {
+    return std::log(beta / (1.0 - alpha));
+}
+
+/**
+ * @brief Gets the log-likelihood ratio above which the SPRT accepts elo1
+ */
+double SprtBounds::upper() const {
+    return std::log((1.0 - beta) / alpha);
+}
+
+/**
+ * @brief Converts an Elo difference to the expected score of the stronger side
+ */
+double eloToScore(const double elo) {
+    return 1.0 / (1.0 + std::pow(10.0, -elo / 400.0));
+}
+
+/**
+ * @brief Converts an expected score to an Elo difference
+ * @note Scores of 0 and 1 are moved just inside the range so the difference stays finite
+ */
+double scoreToElo(const double score) {
+    const double clamped = std::clamp(score, 1e-6, 1.0 - 1e-6);
+    return 400.0 * std::log10(clamped / (1.0 - clamped));
+}
+
+/**
+ * @brief Gets the mean score per game, a win scoring 1 and a draw 0.5
+ */
+double TourneyScore::scoreRate() const {
+    return games() == 0 ? 0.5 : (wins + 0.5 * draws) / games();
+}
+
+/**
+ * @brief Gets the variance of the score of one game
+ */
+double TourneyScore::scoreVariance() const {
+    if (games() == 0) {
+        return 0.0;
+    }
+    const double score = scoreRate();
+    return (wins * (1.0 - score) * (1.0 - score) + draws * (0.5 - score) * (0.5 - score) + losses * score * score) / games();
+}
+
+/**
+ * @brief Estimates the Elo difference from the games so far
+ * @return The difference and the half width of its 95% confidence interval, taken from the
+ * interval of the mean score
+ */
+EloEstimate TourneyScore::elo() const {
+    const double score = scoreRate();
+    const double error = games() == 0 ? 0.0 : std::sqrt(scoreVariance() / games());
+    const double low = scoreToElo(score - CONFIDENCE_QUANTILE * error);
+    const double high = scoreToElo(score + CONFIDENCE_QUANTILE * error);
+    return {scoreToElo(score), (high - low) / 2.0};
+}
+
+/**
+ * @brief Gets the log-likelihood ratio of elo1 against elo0
+ * @param bounds The hypotheses
+ * @return The ratio, by the normal approximation of the generalised SPRT with the score variance
+ * measured from the games, or 0 before there is any variance
+ */
+double TourneyScore::logLikelihoodRatio(const SprtBounds &bounds) const {
+    const double variance = scoreVariance();
+    if (variance <= 0.0) {
+        return 0.0;
+    }
+    const double score0 = eloToScore(bounds.elo0);
+    const double score1 = eloToScore(bounds.elo1);
+    return games() * (score1 - score0) * (2.0 * scoreRate() - score0 - score1) / (2.0 * variance);
+}
+
+/**
+ * @brief How a tournament game ended
+ */
+enum class GameEnd {
+    CAPTURE,    // A player lost their last dot
+    STALEMATE,  // The player to move had no legal actions and lost
+    MAX_PLIES   // The game reached the ply limit and was drawn
+};
+
+/**
+ * @brief The result of one tournament game, as written to the results file
+ */
+struct GameRecord {
+    int index;
+    std::uint64_t seed;
+    Map map;
+    int firstID;     // The player ID configuration A played as
+    int halfPoints;  // A's score: 2 for a win, 1 for a draw and 0 for a loss
+    int plies;
+    GameEnd end;
+    double seconds;
+};
+
+/**
+ * @brief The searchers and table of one configuration on one worker, kept between games
+ */
+struct SideState {
+    std::unique_ptr<TranspositionTable> table;
+    std::unique_ptr<Searcher> searcher;
+    std::unique_ptr<MctsSearcher> mctsSearcher;
+};
+
+/**
+ * @brief Everything a worker keeps between the games it plays
+ */
+struct TourneyWorker {
+    std::array<SideState, 2> sides;  // Configuration A then B
+    std::unique_ptr<ActionList> actions;
+};
+
+/**
+ * @brief Chooses an action for a configuration
+ * @return The action, or std::nullopt if the search found none
+ */
+std::optional<Action> chooseAction(const PlayerConfig &config, SideState &side, Game &game) {
+    if (config.type == PlayerType::MCTS) {
+        return side.mctsSearcher->search(game, {config.milliseconds / 1000.0, 1, config.tableMegabytes}).bestAction;
+    }
+    return side.searcher->search(game, {config.depth, config.nodes, config.milliseconds / 1000.0}).bestAction;
+}
+
+/**
+ * @brief Plays one game of a tournament
+ * @param options The tournament
+ * @param index The number of the game. Games 2k and 2k + 1 are a pair on the same map and seed,
+ * with configuration A playing player 1 in the first and player 2 in the second
+ * @param worker The state of the worker playing the game
+ * @return The result
+ * @note The map, random opening plies and powerup placements all come from the pair's seed, and
+ * placements are drawn from their own generator so searches using random numbers cannot change them
+ */
+GameRecord playTourneyGame(const TourneyOptions &options, const int index, TourneyWorker &worker) {
+    const auto startTime = std::chrono::steady_clock::now();
+    const int pair = index / 2;
+    GameRecord record{index, Random::deriveSeed(options.seed, static_cast<std::uint64_t>(pair)), options.maps[pair % options.maps.size()], index % 2 == 0 ? 1 : 2, 1, 0, GameEnd::MAX_PLIES, 0.0};
+    // Separate streams of the pair's seed, so the opening and the placements do not repeat the map's draws
+    Random random(Random::deriveSeed(record.seed, 0));
+    SettingsData settings;
+    settings.map = record.map;
+    if (record.map == Map::RANDOM) {
+        settings.length = random.getInt(MIN_BOARD_LENGTH, MAX_BOARD_LENGTH);
+        settings.width = random.getInt(MIN_BOARD_WIDTH, MAX_BOARD_WIDTH);
+    }
+    // Map generation draws from the calling thread's generator
+    Random::getInstance().seed(Random::deriveSeed(record.seed, 1));
+    Game game(settings);
+    for (SideState &side : worker.sides) {
+        side.table->clear();
+    }
+
+    ActionList &actions = *worker.actions;
+    int winner = 0;
+    for (; record.plies < options.maxPlies; record.plies++) {
+        if (game.placesPowerups() && game.turnNumber % game.settings.powerupPlacementFrequency == 0) {
+            game.placePowerup(random);
+        }
+        generateActions(game, actions);
+        if (actions.empty()) {
+            winner = 3 - game.currentPlayerID;
+            record.end = GameEnd::STALEMATE;
+            break;
+        }
+        Action action;
+        if (record.plies < options.randomPlies) {
+            action = actions[random.getInt(0, static_cast<int>(actions.size) - 1)];
+        } else {
+            const bool isFirst = game.currentPlayerID == record.firstID;
+            action = chooseAction(isFirst ? options.first : options.second, worker.sides[isFirst ? 0 : 1], game).value_or(actions[0]);
+        }
+        game.makeMove(action);
+        if (game.getAllyPlayer().numPieces == 0) {
+            winner = 3 - game.currentPlayerID;
+            record.end = GameEnd::CAPTURE;
+            record.plies++;
+            break;
+        }
+    }
+    record.halfPoints = winner == 0 ? 1 : winner == record.firstID ? 2 : 0;
+    record.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+    return record;
+}
+
+/**
+ * @brief Formats a game's result as a line of the results file
+ */
+std::string recordToCsv(const GameRecord &record) {
+    constexpr std::array<std::string_view, 3> ENDS = {"capture", "stalemate", "max_plies"};
+    constexpr std::array<std::string_view, 3> SCORES = {"0", "0.5", "1"};
+    return std::format("{},{},{},{},{},{},{},{},{:.3f}", record.index, record.index / 2, record.seed, mapToString(record.map), record.firstID,
+                       SCORES[record.halfPoints], record.plies, ENDS[static_cast<std::size_t>(record.end)], record.seconds);
+}
+
+/**
+ * @brief Formats the standings for a progress report
+ */
+std::string describeScore(const TourneyScore &score, const TourneyOptions &options) {
+    const EloEstimate elo = score.elo();
+    std::string line = std::format("Games {}: +{} ={} -{}, score {:.1f}%, Elo {:+.1f} +/- {:.1f}",
+                                   score.games(), score.wins, score.draws, score.losses, score.scoreRate() * 100, elo.elo, elo.margin);
+    if (options.useSprt) {
+        line += std::format(", LLR {:.2f} ({:.2f}, {:.2f})", score.logLikelihoodRatio(options.sprt), options.sprt.lower(), options.sprt.upper());
+    }
+    return line;
+}
+
+/**
+ * @brief Plays a tournament between two configurations
+ * @param options The tournament
+ * @param log The stream progress and the final standings are reported to
+ * @return The score of configuration A
+ * @throws std::invalid_argument if there are no games, threads or maps
+ * @throws std::runtime_error if the results file cannot be opened
+ * @note Games are played in parallel, one per worker. Each result is appended to the results file
+ * and flushed as soon as its game finishes, so an interrupted run keeps every finished game. With the
+ * SPRT on, no game is started once a hypothesis is accepted
+ */
+TourneyScore runTourney(const TourneyOptions &options, std::ostream &log) {
+    if (options.games < 1 || options.threads < 1 || options.maps.empty()) {
+        throw std::invalid_argument("A tournament needs at least one game, thread and map");
+    }
+    const int numGames = options.games + options.games % 2;
+    const bool isNew = !std::filesystem::exists(options.output) || std::filesystem::file_size(options.output) == 0;
+    std::ofstream results(options.output, std::ios::app);
+    if (!results) {
+        throw std::runtime_error("Could not open results file: " + options.output.string());
+    }
+    if (isNew) {
+        results << "game,pair,seed,map,a_player,a_score,plies,end,seconds" << std::endl;
+    }
+
+    TaskScheduler scheduler(options.threads, static_cast<std::uint32_t>(options.seed));
+    std::vector<TourneyWorker> workers(scheduler.size());
+    for (TourneyWorker &worker : workers) {
+        for (std::size_t i = 0; i < worker.sides.size(); i++) {
+            const PlayerConfig &config = i == 0 ? options.first : options.second;
+            worker.sides[i].table = std::make_unique<TranspositionTable>(config.tableMegabytes, false);
+            worker.sides[i].searcher = std::make_unique<Searcher>(*worker.sides[i].table);
+            worker.sides[i].mctsSearcher = std::make_unique<MctsSearcher>();
+        }
+        worker.actions = std::make_unique<ActionList>();
+    }
+
+    log << std::format("Playing {} games on {} threads\nA: {}\nB: {}", numGames, scheduler.size(), options.first.describe(), options.second.describe()) << std::endl;
+    TourneyScore score;
+    std::mutex scoreMutex;
+    std::atomic<bool> stopped{false};
+    TaskGroup group;
+    for (int i = 0; i < numGames; i++) {
+        scheduler.spawn(group, [i, numGames, &options, &workers, &score, &scoreMutex, &stopped, &results, &log](Worker &worker) {
+            if (stopped.load(std::memory_order_relaxed)) {
+                return;
+            }
+            const GameRecord record = playTourneyGame(options, i, workers[worker.index]);
+            const std::lock_guard<std::mutex> lock(scoreMutex);
+            results << recordToCsv(record) << std::endl;
+            (record.halfPoints == 2 ? score.wins : record.halfPoints == 1 ? score.draws : score.losses)++;
+            if (score.games() % TOURNEY_REPORT_INTERVAL == 0 && score.games() < numGames) {
+                log << describeScore(score, options) << std::endl;
+            }
+            if (options.useSprt && !stopped.load(std::memory_order_relaxed)) {
+                const double ratio = score.logLikelihoodRatio(options.sprt);
+                if (ratio <= options.sprt.lower() || ratio >= options.sprt.upper()) {
+                    stopped.store(true, std::memory_order_relaxed);
+                    log << std::format("SPRT accepts H{}: Elo {} {}", ratio >= options.sprt.upper() ? 1 : 0,
+                                       ratio >= options.sprt.upper() ? ">=" : "<=", ratio >= options.sprt.upper() ? options.sprt.elo1 : options.sprt.elo0)
+                        << std::endl;
+                }
+            }
+        });
+    }
+    scheduler.wait(group);
+    log << describeScore(score, options) << std::endl;
+    log << "Results written to " << options.output.string() << std::endl;
+    return score;
+}
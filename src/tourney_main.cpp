@@ -0,0 +1,98 @@
+#include <algorithm>  // std::max
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "enums.h"
+#include "tourney.h"
+
+/**
+ * @brief Splits a comma separated list
+ */
+std::vector<std::string> splitList(const std::string &list) {
+    std::vector<std::string> items;
+    std::istringstream stream(list);
+    std::string item;
+    while (std::getline(stream, item, ',')) {
+        items.push_back(item);
+    }
+    return items;
+}
+
+/**
+ * @brief Reads the tournament from the command line
+ * @param args The command line arguments after the program name
+ * @return The tournament
+ * @throws std::invalid_argument if an argument is unknown or has no valid value
+ */
+TourneyOptions parseOptions(const std::vector<std::string> &args) {
+    TourneyOptions options;
+    options.threads = static_cast<int>(std::max(std::thread::hardware_concurrency(), 1u));
+    for (std::size_t i = 0; i < args.size(); i += 2) {
+        if (i + 1 == args.size()) {
+            throw std::invalid_argument("No value for " + args[i]);
+        }
+        const std::string &name = args[i];
+        const std::string &value = args[i + 1];
+        if (name == "--a") {
+            options.first = parsePlayerConfig(value);
+        } else if (name == "--b") {
+            options.second = parsePlayerConfig(value);
+        } else if (name == "--games") {
+            options.games = std::stoi(value);
+        } else if (name == "--threads") {
+            options.threads = std::stoi(value);
+        } else if (name == "--seed") {
+            options.seed = std::stoull(value);
+        } else if (name == "--maps") {
+            options.maps.clear();
+            for (const std::string &map : splitList(value)) {
+                options.maps.push_back(stringToMap(map));
+            }
+        } else if (name == "--random-plies") {
+            options.randomPlies = std::stoi(value);
+        } else if (name == "--max-plies") {
+            options.maxPlies = std::stoi(value);
+        } else if (name == "--output") {
+            options.output = value;
+        } else if (name == "--sprt") {
+            const std::vector<std::string> bounds = splitList(value);
+            if (bounds.size() != 2 && bounds.size() != 4) {
+                throw std::invalid_argument("Expected elo0,elo1[,alpha,beta]: " + value);
+            }
+            options.useSprt = true;
+            options.sprt.elo0 = std::stod(bounds[0]);
+            options.sprt.elo1 = std::stod(bounds[1]);
+            if (bounds.size() == 4) {
+                options.sprt.alpha = std::stod(bounds[2]);
+                options.sprt.beta = std::stod(bounds[3]);
+            }
+        } else {
+            throw std::invalid_argument("Unknown argument: " + name);
+        }
+    }
+    return options;
+}
+
+/**
+ * @brief Main function of the tournament runner
+ */
+int main(int argc, char *argv[]) {
+    try {
+        runTourney(parseOptions(std::vector<std::string>(argv + 1, argv + argc)), std::cout);
+        return 0;
+    } catch (const std::invalid_argument &e) {
+        std::cerr << "Invalid arguments: " << e.what() << std::endl;
+    } catch (const std::exception &e) {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+    std::cerr << "Usage: dotto-tourney [--a <player>] [--b <player>] [--games N] [--threads N] [--seed N]\n"
+              << "                     [--maps <map>,...] [--random-plies N] [--max-plies N] [--output <file>]\n"
+              << "                     [--sprt elo0,elo1[,alpha,beta]]\n"
+              << "A player is comma separated settings: type=ab|mcts, depth=N, nodes=N, ms=N, hash=MB" << std::endl;
+    return 1;
+}
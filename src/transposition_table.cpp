@@ -0,0 +1,220 @@
+#include "transposition_table.h"
+
+#include <algorithm>  // std::min
+#include <bit>        // std::bit_floor
+#include <new>        // std::align_val_t
+
+#ifdef __linux__
+#include <sys/mman.h>
+#endif
+
+#include "search.h"
+
+// Slots are aligned to cache lines so a slot never straddles two lines
+const std::size_t SLOT_ALIGNMENT = 64;
+
+// Size of a transparent huge page on Linux
+const std::size_t HUGE_PAGE_SIZE = std::size_t{2} << 20;
+
+// Bit layout of TableSlot::data
+const int DEPTH_SHIFT = 32;
+const int BOUND_SHIFT = 40;
+const int HAS_ACTION_SHIFT = 42;
+const int ACTION_TYPE_SHIFT = 43;
+const int ACTION_ORIGIN_SHIFT = 46;
+const int ACTION_TARGET_SHIFT = 54;
+
+/**
+ * @brief Packs an entry into a single word
+ */
+std::uint64_t packEntry(const TableEntry &entry) {
+    std::uint64_t data = static_cast<std::uint32_t>(entry.score);
+    data |= static_cast<std::uint64_t>(static_cast<std::uint8_t>(entry.depth)) << DEPTH_SHIFT;
+    data |= static_cast<std::uint64_t>(entry.bound) << BOUND_SHIFT;
+    if (entry.bestAction.has_value()) {
+        const Action &action = entry.bestAction.value();
+        data |= std::uint64_t{1} << HAS_ACTION_SHIFT;
+        data |= static_cast<std::uint64_t>(action.type) << ACTION_TYPE_SHIFT;
+        data |= static_cast<std::uint64_t>(action.origin) << ACTION_ORIGIN_SHIFT;
+        data |= static_cast<std::uint64_t>(action.target) << ACTION_TARGET_SHIFT;
+    }
+    return data;
+}
+
+/**
+ * @brief Unpacks an entry packed by packEntry
+ */
+TableEntry unpackEntry(const std::uint64_t data) {
+    TableEntry entry{static_cast<std::int32_t>(static_cast<std::uint32_t>(data)),
+                     static_cast<int>((data >> DEPTH_SHIFT) & 0xFF),
+                     static_cast<Bound>((data >> BOUND_SHIFT) & 0x3),
+                     std::nullopt};
+    if ((data >> HAS_ACTION_SHIFT) & 1) {
+        entry.bestAction = Action{static_cast<ActionType>((data >> ACTION_TYPE_SHIFT) & 0x7),
+                                  static_cast<std::uint8_t>(data >> ACTION_ORIGIN_SHIFT),
+                                  static_cast<std::uint8_t>(data >> ACTION_TARGET_SHIFT)};
+    }
+    return entry;
+}
+
+/**
+ * @brief Construct a new Transposition Table object
+ * @param megabytes The size of the table in MB
+ * @param useHugePages Whether to back the table with huge pages where supported
+ */
+TranspositionTable::TranspositionTable(const std::size_t megabytes, const bool useHugePages) {
+    resize(megabytes, useHugePages);
+}
+
+TranspositionTable::~TranspositionTable() {
+    release();
+}
+
+/**
+ * @brief Reallocates the table, discarding every entry
+ * @param megabytes The size of the table in MB, rounded down to a power of two number of slots
+ * @param useHugePages Whether to back the table with huge pages where supported
+ * @throws std::bad_alloc if the memory cannot be allocated
+ * @note Must not be called while any thread is searching
+ */
+void TranspositionTable::resize(const std::size_t megabytes, const bool useHugePages) {
+    release();
+    numSlots = std::bit_floor(std::max<std::size_t>(megabytes << 20, sizeof(TableSlot)) / sizeof(TableSlot));
+    allocatedBytes = numSlots * sizeof(TableSlot);
+#ifdef __linux__
+    if (useHugePages) {
+        // Round up to whole huge pages, mmap memory is already zeroed
+        allocatedBytes = (allocatedBytes + HUGE_PAGE_SIZE - 1) / HUGE_PAGE_SIZE * HUGE_PAGE_SIZE;
+        void *memory = mmap(nullptr, allocatedBytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (memory == MAP_FAILED) {
+            throw std::bad_alloc();
+        }
+        madvise(memory, allocatedBytes, MADV_HUGEPAGE);  // only a hint, ignored if unsupported
+        slots = static_cast<TableSlot *>(memory);
+        mapped = true;
+        for (std::size_t i = 0; i < numSlots; i++) {
+            new (&slots[i]) TableSlot;
+        }
+        return;
+    }
+#endif
+    static_cast<void>(useHugePages);
+    slots = static_cast<TableSlot *>(::operator new(allocatedBytes, std::align_val_t{SLOT_ALIGNMENT}));
+    mapped = false;
+    for (std::size_t i = 0; i < numSlots; i++) {
+        new (&slots[i]) TableSlot;
+    }
+}
+
+/**
+ * @brief Frees the table's memory
+ */
+void TranspositionTable::release() {
+    if (slots == nullptr) {
+        return;
+    }
+#ifdef __linux__
+    if (mapped) {
+        munmap(slots, allocatedBytes);
+    } else {
+        ::operator delete(slots, std::align_val_t{SLOT_ALIGNMENT});
+    }
+#else
+    ::operator delete(slots, std::align_val_t{SLOT_ALIGNMENT});
+#endif
+    slots = nullptr;
+    numSlots = 0;
+    allocatedBytes = 0;
+}
+
+/**
+ * @brief Empties every slot, e.g. before a new game
+ * @note Must not be called while any thread is searching
+ */
+void TranspositionTable::clear() {
+    for (std::size_t i = 0; i < numSlots; i++) {
+        slots[i].keyXorData.store(0, std::memory_order_relaxed);
+        slots[i].data.store(0, std::memory_order_relaxed);
+    }
+}
+
+/**
+ * @brief Looks up a position
+ * @param hash The hash of the position
+ * @param ply The distance of the position from the root, to convert mate scores back
+ * @return The stored entry, or std::nullopt if the position is not stored
+ */
+std::optional<TableEntry> TranspositionTable::probe(const std::uint64_t hash, const int ply) const {
+    if (numSlots == 0) {
+        return std::nullopt;
+    }
+    const TableSlot &entrySlot = slot(hash);
+    const std::uint64_t data = entrySlot.data.load(std::memory_order_relaxed);
+    const std::uint64_t keyXorData = entrySlot.keyXorData.load(std::memory_order_relaxed);
+    if ((keyXorData ^ data) != hash || data == 0) {
+        return std::nullopt;
+    }
+    TableEntry entry = unpackEntry(data);
+    // Mate scores are stored relative to the position, convert them back to relative to the root
+    if (entry.score >= MATE_BOUND) {
+        entry.score -= ply;
+    } else if (entry.score <= -MATE_BOUND) {
+        entry.score += ply;
+    }
+    return entry;
+}
+
+/**
+ * @brief Stores the result of searching a position
+ * @param hash The hash of the position
+ * @param entry The result to store
+ * @param ply The distance of the position from the root, to store mate scores independently of it
+ * @note Entries of other positions are always replaced, entries of the same position are only
+ * replaced by deeper or exact results. A best action is kept if the new result has none
+ */
+void TranspositionTable::store(const std::uint64_t hash, const TableEntry &entry, const int ply) {
+    if (numSlots == 0) {
+        return;
+    }
+    TableSlot &entrySlot = slot(hash);
+    TableEntry stored = entry;
+    if (stored.score >= MATE_BOUND) {
+        stored.score += ply;
+    } else if (stored.score <= -MATE_BOUND) {
+        stored.score -= ply;
+    }
+    const std::uint64_t oldData = entrySlot.data.load(std::memory_order_relaxed);
+    const std::uint64_t oldKey = entrySlot.keyXorData.load(std::memory_order_relaxed) ^ oldData;
+    if (oldKey == hash && oldData != 0) {
+        const TableEntry old = unpackEntry(oldData);
+        if (stored.depth < old.depth && stored.bound != Bound::EXACT) {
+            return;
+        }
+        if (!stored.bestAction.has_value()) {
+            stored.bestAction = old.bestAction;
+        }
+    }
+    const std::uint64_t data = packEntry(stored);
+    entrySlot.keyXorData.store(hash ^ data, std::memory_order_relaxed);
+    entrySlot.data.store(data, std::memory_order_relaxed);
+}
+
+/**
+ * @brief Gets the number of slots in the table
+ */
+std::size_t TranspositionTable::size() const {
+    return numSlots;
+}
+
+/**
+ * @brief Estimates how full the table is from its first thousand slots
+ * @return The number of used slots per thousand
+ */
+int TranspositionTable::hashfull() const {
+    const std::size_t sample = std::min<std::size_t>(numSlots, 1000);
+    int used = 0;
+    for (std::size_t i = 0; i < sample; i++) {
+        used += slots[i].data.load(std::memory_order_relaxed) != 0;
+    }
+    return sample == 0 ? 0 : static_cast<int>(used * 1000 / sample);
+}